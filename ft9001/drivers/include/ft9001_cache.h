@@ -10,16 +10,46 @@
  *
  * Regions map onto register fields as BOOT to CSACR.ROMR_x (4 slots), ROM to
  * CACR.ROM_*, and SPIM1..3 to CSACR.SPIn_x (4 slots each). Maintenance runs
- * through CCR.INVW1|INVW0|GO for a global invalidate and through CPEA/CPES for a
- * range invalidate.
+ * through CCR.INVWn/PUSHWn|GO for the global operations, through CPEA/CPES for a
+ * range invalidate and through the CLCR/CSAR line commands, one 16-byte line
+ * at a time, for a range clean. All are waited for against a deadline on the
+ * core tick (see ft9001_tick.h) and reported as -ETIMEDOUT if the engine never
+ * finishes.
+ *
+ * Clean pushes dirty write-back lines out to memory and keeps them valid;
+ * clean+invalidate pushes them and then drops them. Before a DMA engine reads
+ * a buffer written through the D-cache, clean it; before the CPU reads a
+ * buffer a DMA engine wrote, invalidate it, or clean+invalidate it if the CPU
+ * may also have written around it. Maintenance on one instance is not
+ * re-entrant.
+ *
+ * BOOT and SPIM1..3 each split into four slots, every slot an address window
+ * (CROMRSxHA/LA, CSPInSxHA/LA) with its own CSACR policy pair. The window
+ * registers hold address bits [25:16] in place, so windows are 64 KB granular
+ * and are matched against the offset within the region's 64 MB span. The
+ * region-wide helpers set the policy of all four slots and leave the windows
+ * alone; @ref ft9001_cache_slot_set maps one window.
+ *
+ * The global operations and the range invalidate also come as start/poll/wait
+ * triplets on a caller-owned @ref ft9001_cache_op, so the CPU can do unrelated
+ * work while the engine runs. Range clean has no such variant: it is issued
+ * line by line from the CPU and gains nothing from being split up.
+ *
+ * Each instance is two ways of 256 sets of 16-byte lines (8 KB), as laid out
+ * by CLCR.CACHE_ADDRESS. The line-level readers go through the CLCR search
+ * command with cache addressing and see the cache live, so a snapshot taken
+ * while code runs from it is a sample, not a frozen image.
  */
 
 #ifndef FT9001_CACHE_H_
 #define FT9001_CACHE_H_
 
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #include "ft9001.h"
+#include "ft9001_tick.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -44,6 +74,32 @@ enum ft9001_cache_region {
 	FT9001_CACHE_REGION_SPIM3,
 };
 
+/** @brief Bytes per cache line. */
+#define FT9001_CACHE_LINE_SIZE (16U)
+
+/** @brief Ways per instance. */
+#define FT9001_CACHE_WAY_COUNT (2U)
+
+/** @brief Sets per way. */
+#define FT9001_CACHE_SET_COUNT (256U)
+
+/**
+ * @brief Default range size from which @ref ft9001_cache_invalidate_range
+ *        invalidates globally: the cache size, past which a page operation
+ *        walks more lines than the cache can hold.
+ */
+#define FT9001_CACHE_INVAL_GLOBAL_MIN_DEFAULT                                              \
+	(FT9001_CACHE_WAY_COUNT * FT9001_CACHE_SET_COUNT * FT9001_CACHE_LINE_SIZE)
+
+/** @brief Address windows per slotted region (BOOT, SPIM1..3). */
+#define FT9001_CACHE_SLOT_COUNT (4U)
+
+/** @brief Granularity of a slot window; base and size are multiples of it. */
+#define FT9001_CACHE_SLOT_ALIGN (0x10000UL)
+
+/** @brief Span of a slotted region, which window offsets are taken within. */
+#define FT9001_CACHE_SLOT_SPAN (0x4000000UL)
+
 /** @brief Region policies applied together by the bulk helpers. */
 struct ft9001_cache_config {
 	enum ft9001_cache_mode boot;
@@ -53,18 +109,145 @@ struct ft9001_cache_config {
 	enum ft9001_cache_mode spim3;
 };
 
+/** @brief One cache line as read back through the line commands. */
+struct ft9001_cache_line {
+	/** Memory address the line holds, rebuilt from tag and set. */
+	uint32_t addr;
+	bool valid;
+	/** Holds data not yet pushed to memory (write-back only). */
+	bool dirty;
+	uint32_t data[FT9001_CACHE_LINE_SIZE / 4U];
+};
+
+/**
+ * @brief Address window counted by @ref ft9001_cache_occupancy.
+ *
+ * The caller fills in @p base and @p size, typically from linker symbols of a
+ * hot code or data section; the counters are outputs.
+ */
+struct ft9001_cache_window {
+	uint32_t base;
+	uint32_t size;
+	/** Valid lines holding an address inside the window. */
+	uint32_t lines;
+	/** Of those, the dirty ones. */
+	uint32_t dirty;
+};
+
+/**
+ * @brief Asynchronous maintenance operation.
+ *
+ * Storage belongs to the caller and must stay valid until the operation is
+ * done. Only one operation may be in flight per instance. All fields are
+ * private.
+ */
+struct ft9001_cache_op {
+	CACHE_TypeDef *inst;
+	/* Next page to invalidate and bytes left after it; 0 for a global op. */
+	uint32_t next;
+	uint32_t left;
+	struct ft9001_deadline dl;
+	int result;
+	bool done;
+};
+
+/**
+ * @brief CSACR byte for one region: its four slots share the policy.
+ *
+ * Each slot is a CACHEABLE/WT_WB pair, so write-through sets every other bit
+ * and write-back sets them all.
+ */
+#define FT9001_CACHE_CSACR_MODE(mode)                                                      \
+	((mode) == FT9001_CACHE_MODE_WRITE_BACK      ? 0xFFUL                              \
+	 : (mode) == FT9001_CACHE_MODE_WRITE_THROUGH ? 0xAAUL                              \
+						     : 0x00UL)
+
+/** @brief Whole CSACR value for the region policies, one byte per region. */
+#define FT9001_CACHE_CSACR_VAL(boot, spim1, spim2, spim3)                                  \
+	((FT9001_CACHE_CSACR_MODE(boot) << CACHE_CSACR_ROMR_0_WT_WB_Pos) |                 \
+	 (FT9001_CACHE_CSACR_MODE(spim2) << CACHE_CSACR_SPI2_0_WT_WB_Pos) |                \
+	 (FT9001_CACHE_CSACR_MODE(spim1) << CACHE_CSACR_SPI1_0_WT_WB_Pos) |                \
+	 (FT9001_CACHE_CSACR_MODE(spim3) << CACHE_CSACR_SPI3_0_WT_WB_Pos))
+
+/** @brief CACR.ROM_CACHEABLE and ROM_WT_WB for a ROM region policy. */
+#define FT9001_CACHE_CACR_ROM_VAL(mode)                                                    \
+	((FT9001_CACHE_CSACR_MODE(mode) & 0x3UL) << CACHE_CACR_ROM_WT_WB_Pos)
+
+/**
+ * @brief Region policies packed into their registers.
+ *
+ * Build with @ref FT9001_CACHE_CSACR_VAL and @ref FT9001_CACHE_CACR_ROM_VAL,
+ * so a policy fixed at build time costs two register writes.
+ */
+struct ft9001_cache_regs {
+	/** Whole CSACR value. */
+	uint32_t csacr;
+	/** CACR ROM bits; the other CACR fields are left alone. */
+	uint32_t cacr_rom;
+};
+
 /** @brief Enable the cache instance (CCR.ENCACHE). */
 static inline void ft9001_cache_enable(CACHE_TypeDef *inst)
 {
 	FT9001_SET_BIT(inst->CACHE_CCR, CACHE_CCR_ENCACHE);
 }
 
-/** @brief Disable the cache instance (CCR.ENCACHE). */
+/**
+ * @brief Disable the cache instance (CCR.ENCACHE).
+ *
+ * The cache keeps its clock; see @ref ft9001_cache_power_off.
+ */
 static inline void ft9001_cache_disable(CACHE_TypeDef *inst)
 {
 	FT9001_CLEAR_BIT(inst->CACHE_CCR, CACHE_CCR_ENCACHE);
 }
 
+/**
+ * @brief Turn a cache instance off and stop its clock (CCG.CLK_ENABLE).
+ *
+ * Dirty lines are pushed out first when a region is write-back, so memory is
+ * current while the cache is off. Must not be called on the instance caching
+ * the calling code.
+ *
+ * While the clock is stopped the global maintenance calls
+ * (@ref ft9001_cache_invalidate_all, @ref ft9001_cache_clean_all,
+ * @ref ft9001_cache_clean_invalidate_all and their _start variants, and the
+ * range invalidates) return 0 without issuing anything: the engine would
+ * never finish, and the cache holds nothing that
+ * @ref ft9001_cache_power_on does not invalidate first.
+ *
+ * @retval 0          Off and gated.
+ * @retval -ETIMEDOUT The clean did not finish; the cache is left running.
+ */
+int ft9001_cache_power_off(CACHE_TypeDef *inst);
+
+/**
+ * @brief Restart the clock of a cache instance, invalidate and enable it.
+ *
+ * Memory may have changed while the cache was off, so every line is dropped.
+ *
+ * @retval 0          Enabled.
+ * @retval -ETIMEDOUT The invalidate did not finish; the cache is left off.
+ */
+int ft9001_cache_power_on(CACHE_TypeDef *inst);
+
+/**
+ * @brief Get an instance ready for a sleep mode.
+ *
+ * Called by the sleep driver just before it programs the CPM. The arrays keep
+ * their lines when only the clocks stop, and nothing behind a cached region
+ * changes while the core sleeps, so that needs no work either way. A mode that
+ * powers the arrays down only costs a clean of the dirty lines, and only when
+ * a region is write-back. Wake-up from such a mode goes through reset and
+ * SystemInit(), so there is no matching resume call.
+ *
+ * @param  inst          Cache instance.
+ * @param  contents_lost The mode powers the cache arrays down.
+ * @retval 0             Ready.
+ * @retval -ETIMEDOUT    The clean did not finish.
+ */
+int ft9001_cache_sleep_prepare(CACHE_TypeDef *inst, bool contents_lost);
+
 /** @brief Set the policy for one region. */
 void ft9001_cache_region_mode_set(CACHE_TypeDef *inst, enum ft9001_cache_region region,
 				  enum ft9001_cache_mode mode);
@@ -72,23 +255,253 @@ void ft9001_cache_region_mode_set(CACHE_TypeDef *inst, enum ft9001_cache_region
 /** @brief Set the policy for every region in one call. */
 void ft9001_cache_regions_configure(CACHE_TypeDef *inst, const struct ft9001_cache_config *cfg);
 
-/** @brief Invalidate all ways and lines, waiting for CCR.GO to clear. */
-void ft9001_cache_invalidate_all(CACHE_TypeDef *inst);
+/**
+ * @brief Map one slot of a region to an address window and a policy.
+ *
+ * Only bits [25:0] of @p addr are used, so the region's bus address or an
+ * offset within it both work. The slot is made uncacheable while its window
+ * moves. With the cache on, every line is then pushed out and invalidated, so
+ * nothing cached under the old window survives; keep windows of one region
+ * disjoint.
+ *
+ * @param inst   Cache instance.
+ * @param region BOOT or SPIM1..3.
+ * @param slot   0 to FT9001_CACHE_SLOT_COUNT - 1.
+ * @param addr   Window start, a multiple of FT9001_CACHE_SLOT_ALIGN.
+ * @param size   Window length, a non-zero multiple of FT9001_CACHE_SLOT_ALIGN,
+ *               not crossing FT9001_CACHE_SLOT_SPAN.
+ * @param mode   Policy for accesses inside the window.
+ * @retval 0          Mapped.
+ * @retval -EINVAL    ROM region (no slots), slot out of range or a misaligned
+ *                    or oversized window.
+ * @retval -ETIMEDOUT The window is mapped but the clean+invalidate did not
+ *                    finish.
+ */
+int ft9001_cache_slot_set(CACHE_TypeDef *inst, enum ft9001_cache_region region, uint32_t slot,
+			  uint32_t addr, uint32_t size, enum ft9001_cache_mode mode);
+
+/**
+ * @brief Read back the window and policy of one slot.
+ *
+ * @param addr Window start as an offset within the region's span.
+ * @param size Window length.
+ * @param mode Policy.
+ * @retval 0       Read.
+ * @retval -EINVAL ROM region or slot out of range.
+ */
+int ft9001_cache_slot_get(CACHE_TypeDef *inst, enum ft9001_cache_region region, uint32_t slot,
+			  uint32_t *addr, uint32_t *size, enum ft9001_cache_mode *mode);
+
+/**
+ * @brief Invalidate all ways and lines, waiting for CCR.GO to clear.
+ *
+ * @retval 0          Invalidated, or the cache clock is stopped.
+ * @retval -ETIMEDOUT CCR.GO did not clear.
+ */
+int ft9001_cache_invalidate_all(CACHE_TypeDef *inst);
 
 /**
  * @brief Invalidate an address range.
  *
  * The start is aligned down and the length up to the 16-byte line size, so no
  * alignment is required from the caller. Does nothing while the cache is off.
+ *
+ * Ranges beyond what one CPES page operation covers are split into several.
+ * From the size set with @ref ft9001_cache_inval_global_min_set on, the whole
+ * cache is invalidated instead, as long as no region of the instance is
+ * write-back: a global invalidate would otherwise drop dirty lines outside
+ * the range.
+ *
+ * @retval 0          Invalidated, or the cache is off.
+ * @retval -ETIMEDOUT CPES.START_INVAL or CCR.GO did not clear.
  */
-void ft9001_cache_invalidate_range(CACHE_TypeDef *inst, uint32_t addr, uint32_t size);
+int ft9001_cache_invalidate_range(CACHE_TypeDef *inst, uint32_t addr, uint32_t size);
+
+/**
+ * @brief Set the range size from which range invalidates go global.
+ *
+ * Lower it when refilling the cache is cheap compared with walking the range,
+ * raise it when the cache holds hot code that other ranges should not evict.
+ * UINT32_MAX keeps every invalidate page-based. Applies to both instances.
+ *
+ * @param bytes Threshold, defaults to FT9001_CACHE_INVAL_GLOBAL_MIN_DEFAULT.
+ */
+void ft9001_cache_inval_global_min_set(uint32_t bytes);
+
+/** @brief Current threshold of @ref ft9001_cache_inval_global_min_set. */
+uint32_t ft9001_cache_inval_global_min_get(void);
+
+/**
+ * @brief Push every dirty line of both ways out to memory, waiting for CCR.GO
+ *        to clear.
+ *
+ * The lines stay valid. A no-op for write-through and uncached regions.
+ *
+ * @retval 0          Cleaned, or the cache clock is stopped.
+ * @retval -ETIMEDOUT CCR.GO did not clear.
+ */
+int ft9001_cache_clean_all(CACHE_TypeDef *inst);
+
+/**
+ * @brief Push every dirty line out and invalidate all ways, waiting for CCR.GO
+ *        to clear.
+ *
+ * @retval 0          Cleaned and invalidated, or the cache clock is stopped.
+ * @retval -ETIMEDOUT CCR.GO did not clear.
+ */
+int ft9001_cache_clean_invalidate_all(CACHE_TypeDef *inst);
+
+/**
+ * @brief Push the dirty lines of an address range out to memory.
+ *
+ * Aligned to the line size like @ref ft9001_cache_invalidate_range, and
+ * issued as one push line command per line, so the cost grows with @p size;
+ * for ranges approaching the cache size @ref ft9001_cache_clean_all is
+ * cheaper. Does nothing while the cache is off.
+ *
+ * @retval 0          Cleaned, or the cache is off.
+ * @retval -ETIMEDOUT A line command did not finish (CSAR.LGO stuck).
+ */
+int ft9001_cache_clean_range(CACHE_TypeDef *inst, uint32_t addr, uint32_t size);
+
+/**
+ * @brief Push the dirty lines of an address range out, then invalidate them.
+ *
+ * Same alignment and cost as @ref ft9001_cache_clean_range.
+ *
+ * @retval 0          Cleaned and invalidated, or the cache is off.
+ * @retval -ETIMEDOUT A line command did not finish (CSAR.LGO stuck).
+ */
+int ft9001_cache_clean_invalidate_range(CACHE_TypeDef *inst, uint32_t addr, uint32_t size);
+
+/**
+ * @brief Start a global invalidate without waiting for it.
+ *
+ * @param  op         Operation object.
+ * @param  inst       Cache instance.
+ * @param  timeout_us Time allowed from now to the end of the operation, or
+ *                    @ref FT9001_TICK_FOREVER.
+ * @retval 0          Started, or the cache clock is stopped and the operation
+ *                    is done at once.
+ * @retval -EBUSY     The instance is still running a previous operation;
+ *                    nothing was started.
+ */
+int ft9001_cache_invalidate_all_start(struct ft9001_cache_op *op, CACHE_TypeDef *inst,
+				      uint32_t timeout_us);
+
+/**
+ * @brief Start a global clean without waiting for it.
+ *
+ * @retval 0      Started, or the cache clock is stopped.
+ * @retval -EBUSY See @ref ft9001_cache_invalidate_all_start.
+ */
+int ft9001_cache_clean_all_start(struct ft9001_cache_op *op, CACHE_TypeDef *inst,
+				 uint32_t timeout_us);
+
+/**
+ * @brief Start a global clean+invalidate without waiting for it.
+ *
+ * @retval 0      Started, or the cache clock is stopped.
+ * @retval -EBUSY See @ref ft9001_cache_invalidate_all_start.
+ */
+int ft9001_cache_clean_invalidate_all_start(struct ft9001_cache_op *op, CACHE_TypeDef *inst,
+					    uint32_t timeout_us);
+
+/**
+ * @brief Start a range invalidate without waiting for it.
+ *
+ * Takes the same path as @ref ft9001_cache_invalidate_range: a range larger
+ * than one page operation runs as several, each issued by the poll or wait
+ * call that sees the previous one finish, and a range past the global
+ * threshold runs as a global invalidate. With the cache off or its clock
+ * stopped the operation is done at once.
+ *
+ * @retval 0      Started, or nothing to do.
+ * @retval -EBUSY See @ref ft9001_cache_invalidate_all_start.
+ */
+int ft9001_cache_invalidate_range_start(struct ft9001_cache_op *op, CACHE_TypeDef *inst,
+					uint32_t addr, uint32_t size, uint32_t timeout_us);
+
+/**
+ * @brief Check on a started operation without blocking.
+ *
+ * @retval -EINPROGRESS Still running.
+ * @retval 0            Done.
+ * @retval -ETIMEDOUT   The deadline passed first.
+ */
+int ft9001_cache_op_poll(struct ft9001_cache_op *op);
+
+/**
+ * @brief Wait for a started operation to finish, within the deadline given at
+ *        start. Calling it again returns the same result.
+ *
+ * @retval 0          Done.
+ * @retval -ETIMEDOUT The deadline passed first.
+ */
+int ft9001_cache_op_wait(struct ft9001_cache_op *op);
+
+/**
+ * @brief Wait for an operation and order it before what follows.
+ *
+ * Call right before consuming the maintained data: after the wait, DSB keeps
+ * later loads from running ahead of it and ISB refetches instructions, so
+ * freshly invalidated code is read from memory.
+ *
+ * @retval 0          Done.
+ * @retval -ETIMEDOUT The deadline passed first; the data must not be used.
+ */
+int ft9001_cache_op_barrier(struct ft9001_cache_op *op);
+
+/**
+ * @brief Read the tag, state and data of one line.
+ *
+ * @p line->data is only meaningful when @p line->valid is set.
+ *
+ * @retval 0          Read.
+ * @retval -EINVAL    Way or set out of range.
+ * @retval -ETIMEDOUT A line command did not finish (CLCR.LGO stuck).
+ */
+int ft9001_cache_line_read(CACHE_TypeDef *inst, uint32_t way, uint32_t set,
+			   struct ft9001_cache_line *line);
+
+/**
+ * @brief Count resident lines per address window.
+ *
+ * Walks the tags of every line once and credits each valid line to every
+ * window holding its address, so overlapping windows are each counted in
+ * full. Lines outside all windows only show up in @p valid_lines.
+ *
+ * @param inst        Cache instance.
+ * @param windows     Windows to count, counters overwritten. May be NULL if
+ *                    @p count is 0.
+ * @param count       Number of windows.
+ * @param valid_lines If not NULL, receives the number of valid lines overall.
+ * @param dirty_lines If not NULL, receives the number of dirty lines overall.
+ * @retval 0          Counted.
+ * @retval -ETIMEDOUT A line command did not finish; the counters are partial.
+ */
+int ft9001_cache_occupancy(CACHE_TypeDef *inst, struct ft9001_cache_window *windows,
+			   size_t count, uint32_t *valid_lines, uint32_t *dirty_lines);
 
 /**
  * @brief Bring a cache instance up: disable, configure, invalidate, enable.
  *
- * Performs a global invalidate on every call.
+ * Performs a global invalidate on every call, and restarts the cache clock if
+ * @ref ft9001_cache_power_off stopped it.
+ *
+ * @retval 0          Enabled.
+ * @retval -ETIMEDOUT The invalidate did not finish; the cache is left off
+ *                    rather than enabled over stale lines.
+ */
+int ft9001_cache_init(CACHE_TypeDef *inst, const struct ft9001_cache_config *cfg);
+
+/**
+ * @brief Same as @ref ft9001_cache_init, from packed region policies.
+ *
+ * @retval 0          Enabled.
+ * @retval -ETIMEDOUT See @ref ft9001_cache_init.
  */
-void ft9001_cache_init(CACHE_TypeDef *inst, const struct ft9001_cache_config *cfg);
+int ft9001_cache_init_regs(CACHE_TypeDef *inst, const struct ft9001_cache_regs *regs);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2026, FocalTech Systems CO.,Ltd
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file    ft9001_cache_bench.h
+ * @brief   FT9001 D-cache benchmark for the BOOT, ROM and SPIM regions.
+ *
+ * Runs three read-only kernels against a caller-given window of each region,
+ * once uncached and once cached, and keeps the best time of each:
+ * - interp: a branchy byte-code loop that loads its opcodes from the window;
+ * - memcpy: block copies from the window into an SRAM buffer;
+ * - lookup: pseudo-random word lookups across the window.
+ *
+ * Only the D-cache policy of the region is changed. The benchmark code runs
+ * from wherever it is linked, so it says nothing about instruction fetch from
+ * the region and leaves the I-cache alone. These regions are read-only
+ * flash, so there are no stores to tell write-through from write-back: the
+ * cached run uses write-through, and it stands for both.
+ *
+ * Before each kernel the D-cache is cleaned and invalidated and the kernel
+ * runs once untimed, so the figures are warm-cache times. The timed runs are
+ * taken with interrupts masked and measured on the core tick (ft9001_tick.h).
+ * The D-cache region policies in force before the run are restored
+ * afterwards. Nothing here writes to a console; format the results with
+ * @ref ft9001_cache_bench_print through the caller's output routine.
+ */
+
+#ifndef FT9001_CACHE_BENCH_H_
+#define FT9001_CACHE_BENCH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ft9001_cache.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief D-cache policies measured. */
+enum ft9001_cache_bench_policy {
+	FT9001_CACHE_BENCH_OFF = 0,
+	FT9001_CACHE_BENCH_CACHED,
+	FT9001_CACHE_BENCH_POLICY_COUNT,
+};
+
+/** @brief Benchmark kernels. */
+enum ft9001_cache_bench_kernel {
+	FT9001_CACHE_BENCH_INTERP = 0,
+	FT9001_CACHE_BENCH_MEMCPY,
+	FT9001_CACHE_BENCH_LOOKUP,
+	FT9001_CACHE_BENCH_KERNEL_COUNT,
+};
+
+/**
+ * @brief One region under test.
+ *
+ * The caller fills in @p region, @p addr and @p size; @p ticks is the output.
+ */
+struct ft9001_cache_bench_target {
+	enum ft9001_cache_region region;
+	/** Start of a readable window inside the region. */
+	uint32_t addr;
+	/** Window length in bytes, at least 64; twice the cache size or more
+	 *  shows capacity misses as well.
+	 */
+	uint32_t size;
+	/** Best time per policy and kernel, in core ticks. */
+	uint32_t ticks[FT9001_CACHE_BENCH_POLICY_COUNT][FT9001_CACHE_BENCH_KERNEL_COUNT];
+};
+
+/** @brief Output routine for @ref ft9001_cache_bench_print, one line per call. */
+typedef void (*ft9001_cache_bench_print_t)(const char *line, void *user_data);
+
+/**
+ * @brief Measure every kernel uncached and cached for each target.
+ *
+ * @param  targets Regions to measure.
+ * @param  count   Number of targets.
+ * @param  reps    Timed runs per kernel and policy; the best is kept.
+ * @retval 0          Measured.
+ * @retval -EINVAL    An unknown region, a window shorter than 64 bytes, or
+ *                    @p reps of 0; nothing was measured.
+ * @retval -ETIMEDOUT A cache maintenance operation did not finish; the
+ *                    previous policies are still restored.
+ */
+int ft9001_cache_bench_run(struct ft9001_cache_bench_target *targets, size_t count,
+			   uint32_t reps);
+
+/**
+ * @brief Print the results as a table, one row per target and kernel.
+ *
+ * Columns give the time in microseconds uncached and cached, and the speed-up
+ * of the cached run.
+ */
+void ft9001_cache_bench_print(const struct ft9001_cache_bench_target *targets, size_t count,
+			      ft9001_cache_bench_print_t print, void *user_data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FT9001_CACHE_BENCH_H_ */
@@ -9,27 +9,45 @@
  * @brief   FT9001 clock and power management.
  *
  * Covers system clock source selection, the high-speed oscillator trim held in
- * OTP, the IPS bus divider and the resulting core frequency.
+ * OTP, the bus and peripheral dividers and the resulting domain frequencies.
  *
- * None of these routines are re-entrant. Call them during early initialisation
- * or from a context that has exclusive access to the CPM registers.
+ * Domain frequencies come from a clock-tree model that is computed once and
+ * refreshed by the setters in this file, so reading them does not touch the
+ * bus. Listeners can subscribe to be told when a domain changes.
+ *
+ * Concurrency: every getter, including the domain frequencies, is safe from
+ * any context, interrupts included. Shared CPM registers are only changed
+ * through masked read-modify-write sequences, and the protected trim unlock
+ * runs with interrupts masked. A reconfiguration that takes several steps or
+ * waits (clock switch, trim load, OSCL switch, calibration, divider plans,
+ * oscillator power-down) claims the CPM for its duration. A second
+ * one started meanwhile, from another thread or from a clock listener,
+ * fails with -EBUSY instead of interleaving; retry it later. These may wait
+ * on the hardware, so call them from thread context.
  */
 
 #ifndef FT9001_CPM_H_
 #define FT9001_CPM_H_
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include "ft9001.h"
+#include "ft9001_tick.h"
+
+#ifdef CONFIG_FT9001_CLOCK_PLAN_FIXED
+#include "ft9001_boot_plan.h"
+#endif
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 /**
- * @brief Poll indefinitely instead of giving up after a bounded number of reads.
+ * @brief Wait indefinitely; kept for callers written against the poll budgets,
+ *        now the same as @ref FT9001_TICK_FOREVER.
  */
-#define FT9001_CPM_POLL_FOREVER 0U
+#define FT9001_CPM_POLL_FOREVER FT9001_TICK_FOREVER
 
 /** @brief System clock source, encoded into CSWCFGR.SYS_SEL. */
 enum ft9001_cpm_sysclk_source {
@@ -39,28 +57,327 @@ enum ft9001_cpm_sysclk_source {
 	FT9001_CPM_SYSCLK_OSC400M = 1U,
 };
 
+/**
+ * @brief Oscillators the HAL can switch, besides OSC8M.
+ *
+ * Each also has a stable-time register, see ft9001_cpm_stime.h.
+ */
+enum ft9001_cpm_osc {
+	/** PMU 128 kHz RC oscillator, OSCLSTIMER. */
+	FT9001_CPM_OSC_PMU128K = 0,
+	/** High-speed oscillator, OSCHSTIMER. */
+	FT9001_CPM_OSC_HSOSC,
+	/** External crystal oscillator, OSCESTIMER. */
+	FT9001_CPM_OSC_OSCEXT,
+	/** 32.768 kHz RTC crystal, RTCSTIMER. */
+	FT9001_CPM_OSC_RTC32K,
+	FT9001_CPM_OSC_COUNT,
+};
+
+/** @brief Low-speed clock OSCL source, encoded into CSWCFGR.OSCL_SEL. */
+enum ft9001_cpm_oscl_source {
+	/** PMU 128 kHz RC oscillator; always available, drifts with temperature. */
+	FT9001_CPM_OSCL_PMU128K = 0U,
+	/** 32.768 kHz RTC crystal; needs the crystal fitted. */
+	FT9001_CPM_OSCL_RTC32K = 1U,
+};
+
 /** @brief High-speed oscillator nominal frequency, selecting which OTP trim to load. */
 enum ft9001_cpm_osc_freq {
 	FT9001_CPM_OSC_FREQ_320MHZ = 0U,
 	FT9001_CPM_OSC_FREQ_400MHZ = 1U,
+	FT9001_CPM_OSC_FREQ_COUNT,
 };
 
+/** @brief Clock domains covered by the clock-tree model. */
+enum ft9001_cpm_clk {
+	/** Core clock (HCLK): source divided by SCDIVR.SYS_DIV. */
+	FT9001_CPM_CLK_SYS = 0,
+	/** AHB3 bus: SYS divided by PCDIVR1.AHB3_DIV. */
+	FT9001_CPM_CLK_AHB3,
+	/** Arithmetic accelerators: SYS divided by PCDIVR1.ARITH_DIV. */
+	FT9001_CPM_CLK_ARITH,
+	/** IPS peripheral bus: SYS divided by PCDIVR1.IPS_DIV. */
+	FT9001_CPM_CLK_IPS,
+	/** Timer/counter: IPS divided by PCDIVR2.TC_DIV. */
+	FT9001_CPM_CLK_TC,
+	/** ADC: IPS divided by PCDIVR2.ADC_DIV. */
+	FT9001_CPM_CLK_ADC,
+	/** Trace port: SYS divided by SCDIVR.TRACE_DIV. */
+	FT9001_CPM_CLK_TRACE,
+	/** CLKOUT pin: CSWCFGR.CLKOUT_SEL source divided by SCDIVR.CLKOUT_DIV. */
+	FT9001_CPM_CLK_CLKOUT,
+	/** Memory card controller: IPS divided by PCDIVR2.MCC_DIV. */
+	FT9001_CPM_CLK_MCC,
+	/** Mesh: IPS divided by PCDIVR2.MESH_DIV. */
+	FT9001_CPM_CLK_MESH,
+	/** I2S master: SYS divided by PCDIVR4.I2S_M_DIV. */
+	FT9001_CPM_CLK_I2S_M,
+	/** I2S slave: SYS divided by PCDIVR4.I2S_S_DIV. */
+	FT9001_CPM_CLK_I2S_S,
+	FT9001_CPM_CLK_COUNT,
+};
+
+/** @brief Mask bit for one domain, as used by the listener mask and callback. */
+#define FT9001_CPM_CLK_BIT(clk) (1UL << (uint32_t)(clk))
+
+/** @brief Mask covering every domain. */
+#define FT9001_CPM_CLK_ALL ((1UL << (uint32_t)FT9001_CPM_CLK_COUNT) - 1UL)
+
 /**
- * @brief Load the high-speed oscillator trim from OTP into O400MTRIMR.
+ * @brief Clock change callback.
+ *
+ * Runs in the context of the CPM call that changed the clock, after the new
+ * configuration is in effect, so @ref ft9001_cpm_clk_freq_hz_get already
+ * returns the new values. That call still holds the CPM, so a
+ * reconfiguration started from the callback fails with -EBUSY.
+ *
+ * @param changed   FT9001_CPM_CLK_BIT() flags of the domains that changed,
+ *                  restricted to the listener's mask.
+ * @param user_data Pointer given at registration.
+ */
+typedef void (*ft9001_cpm_clk_cb_t)(uint32_t changed, void *user_data);
+
+/**
+ * @brief Clock pre-change callback.
+ *
+ * Runs before a reconfiguration the HAL makes itself takes effect: a SYS
+ * source switch and a divider plan or register write. The old clocks still
+ * run, so this is the place to drain a peripheral whose timing is about to
+ * move. Model corrections that do not change any running clock (calibration,
+ * a trim while on OSC8M, OSCL, CLKOUT) only get the post-change callback.
+ *
+ * The same CPM rules apply as for @ref ft9001_cpm_clk_cb_t.
+ *
+ * @param changing  FT9001_CPM_CLK_BIT() flags of the domains about to change,
+ *                  restricted to the listener's mask.
+ * @param next_hz   Predicted frequency of every domain, indexed by
+ *                  enum ft9001_cpm_clk.
+ * @param user_data Pointer given at registration.
+ */
+typedef void (*ft9001_cpm_clk_pre_cb_t)(uint32_t changing,
+					const uint32_t next_hz[FT9001_CPM_CLK_COUNT],
+					void *user_data);
+
+/**
+ * @brief Clock change subscription.
+ *
+ * Storage belongs to the caller and must stay valid while registered. Only
+ * @p cb, @p pre_cb, @p user_data and @p mask are filled in by the caller;
+ * either callback may be NULL, but not both.
+ */
+struct ft9001_cpm_clk_listener {
+	ft9001_cpm_clk_cb_t cb;
+	/** Optional, called before the change. */
+	ft9001_cpm_clk_pre_cb_t pre_cb;
+	void *user_data;
+	/** FT9001_CPM_CLK_BIT() flags of the domains of interest. */
+	uint32_t mask;
+	/* Private, list linkage. */
+	struct ft9001_cpm_clk_listener *next;
+};
+
+/**
+ * @brief Read every OTP trim word into RAM.
+ *
+ * The trim routines parse OTP on first use anyway; call this while the OTP
+ * block is known to be awake (early boot) so that no later trim load, such as a
+ * DFS transition, has to read OTP. Calling it again re-reads OTP.
+ */
+void ft9001_cpm_otp_trim_load(void);
+
+/**
+ * @brief The OTP holds a trim for @p freq.
+ *
+ * Answers from the RAM trim table, parsing OTP on first use.
+ */
+bool ft9001_cpm_hsosc_freq_supported(enum ft9001_cpm_osc_freq freq);
+
+/**
+ * @brief Load the high-speed oscillator trim into O400MTRIMR.
+ *
+ * The trim comes from the RAM table filled by @ref ft9001_cpm_otp_trim_load,
+ * so OTP is read at most once. A missing trim is reported before the clock is
+ * touched.
  *
  * Switches the system clock to OSC8M before writing the protected trim register
  * and leaves it there; run @ref ft9001_cpm_sysclk_source_set afterwards to move
  * back onto the high-speed oscillator. On success the nominal frequency used by
- * @ref ft9001_cpm_sysclk_freq_hz_get is updated to match.
+ * @ref ft9001_cpm_sysclk_freq_hz_get is updated to match. The clock-tree model
+ * is refreshed on every path that reached the OSC8M switch.
  *
  * @param  freq    Requested nominal frequency.
  * @retval 0       Trim found in OTP and written.
  * @retval -EINVAL Unsupported frequency.
  * @retval -ENOENT No valid trim blob in OTP.
  * @retval -ETIMEDOUT Could not switch to OSC8M.
+ * @retval -EBUSY  Another reconfiguration holds the CPM.
  */
 int ft9001_cpm_hsosc_trim_set(enum ft9001_cpm_osc_freq freq);
 
+/**
+ * @brief Report which trim the last successful @ref ft9001_cpm_hsosc_trim_set loaded.
+ *
+ * @retval 0        @p freq filled in.
+ * @retval -ENODATA No trim has been loaded through the HAL since reset.
+ */
+int ft9001_cpm_hsosc_trim_get(enum ft9001_cpm_osc_freq *freq);
+
+/** @brief The high-speed oscillator is enabled and reports stable (OCSR). */
+bool ft9001_cpm_hsosc_is_on(void);
+
+/**
+ * @brief Power the high-speed oscillator down (OCSR.OSC400M_EN).
+ *
+ * The trim in O400MTRIMR is kept, so switching back only costs the
+ * stabilisation wait. Same as @ref ft9001_cpm_osc_disable on
+ * @ref FT9001_CPM_OSC_HSOSC.
+ *
+ * @retval 0      Disabled, or already off.
+ * @retval -EBUSY The system clock is still running from it, or another
+ *                reconfiguration holds the CPM.
+ */
+int ft9001_cpm_hsosc_disable(void);
+
+/**
+ * @brief Power an oscillator up and wait for its STABLE flag (OCSR).
+ *
+ * The flag includes the programmed stable time. Selecting the oscillator as a
+ * clock source is a separate step.
+ *
+ * @param  osc        Oscillator to start.
+ * @param  timeout_us Microseconds, or @ref FT9001_TICK_FOREVER.
+ * @param  stable_us  If not NULL, receives how long the flag took; 0 if the
+ *                    oscillator was already running.
+ * @retval 0          Running and stable.
+ * @retval -EINVAL    Unknown oscillator.
+ * @retval -ETIMEDOUT Not stable by the deadline; left enabled.
+ * @retval -EBUSY     Another reconfiguration holds the CPM; nothing changed.
+ */
+int ft9001_cpm_osc_enable(enum ft9001_cpm_osc osc, uint32_t timeout_us, uint32_t *stable_us);
+
+/**
+ * @brief Power an oscillator down.
+ *
+ * @retval 0       Disabled, or already off.
+ * @retval -EINVAL Unknown oscillator.
+ * @retval -EBUSY  It drives the system clock or OSCL, or another
+ *                 reconfiguration holds the CPM.
+ */
+int ft9001_cpm_osc_disable(enum ft9001_cpm_osc osc);
+
+/** @brief The oscillator is enabled and reports stable (OCSR). */
+bool ft9001_cpm_osc_is_on(enum ft9001_cpm_osc osc);
+
+/**
+ * @brief The oscillator currently drives the system clock or OSCL.
+ *
+ * OSCEXT is never in use in this sense: SYS_SEL cannot select it, so it only
+ * serves as a calibration reference and through the peripherals that take it
+ * directly.
+ */
+bool ft9001_cpm_osc_in_use(enum ft9001_cpm_osc osc);
+
+/** @brief Stable reference used to measure the high-speed oscillator. */
+enum ft9001_cpm_cal_ref {
+	/** 32.768 kHz RTC crystal (OCSR.RTC32K_EN). */
+	FT9001_CPM_CAL_REF_RTC32K = 0,
+	/** External crystal oscillator (OCSR.OSCEXT_EN). */
+	FT9001_CPM_CAL_REF_OSCEXT,
+};
+
+/**
+ * @brief Counter clocked by the calibration reference.
+ *
+ * The CPM cannot count reference edges itself, so the caller supplies a
+ * free-running counter in that clock domain, for instance the RTC prescaler
+ * or a capture timer fed from OSCEXT. It only needs to be monotonic across
+ * the measurement window, wrapping modulo 2^32.
+ */
+struct ft9001_cpm_cal_counter {
+	enum ft9001_cpm_cal_ref ref;
+	/** Reference frequency in Hz, e.g. 32768. */
+	uint32_t ref_hz;
+	/** Read the counter. */
+	uint32_t (*ticks_get)(void *ctx);
+	void *ctx;
+};
+
+/**
+ * @brief Measure the real high-speed oscillator frequency.
+ *
+ * Enables the reference oscillator if needed, then runs the TC block free from
+ * the HSOSC-derived TC clock for @p ref_ticks reference periods, starting on a
+ * reference edge. The TC count and the divider chain from HSOSC to the TC clock
+ * give the oscillator frequency.
+ *
+ * On success the measured value replaces the nominal one in the clock-tree
+ * model, so every domain frequency and, through the clock listeners, every
+ * baud divisor derived from it follows. A later trim load drops it again.
+ *
+ * Borrows the TC block for the window and puts its settings back afterwards
+ * (see ft9001_tc_restore()); a timer that was running loses its count.
+ *
+ * Resolution is one TC count (16 TC clocks) plus the polling jitter on both
+ * reference edges, against a window of @p ref_ticks reference periods; 1024
+ * RTC32K periods (about 31 ms) keep the error in the tens of ppm.
+ *
+ * @param  counter    Reference counter.
+ * @param  ref_ticks  Window length in reference periods.
+ * @param  hsosc_hz   If not NULL, receives the measured frequency.
+ * @retval 0          Measured and applied.
+ * @retval -EINVAL    Bad reference or a zero window.
+ * @retval -ENOTSUP   The system clock is not running from the high-speed
+ *                    oscillator.
+ * @retval -ETIMEDOUT The reference oscillator did not stabilise within 2 s, or
+ *                    the reference counter did not advance within two of its
+ *                    periods.
+ * @retval -EBUSY    Another reconfiguration holds the CPM.
+ */
+int ft9001_cpm_hsosc_calibrate(const struct ft9001_cpm_cal_counter *counter,
+			       uint32_t ref_ticks, uint32_t *hsosc_hz);
+
+/**
+ * @brief Frequency the model uses for the high-speed oscillator, in Hz.
+ *
+ * The last calibration result if there is one for the current trim, otherwise
+ * the nominal trim frequency.
+ */
+uint32_t ft9001_cpm_hsosc_freq_hz_get(void);
+
+/** @brief Nominal frequency of a trim point in Hz, or 0 for an unknown one. */
+uint32_t ft9001_cpm_osc_freq_hz(enum ft9001_cpm_osc_freq freq);
+
+/**
+ * @brief Nominal frequency of the low-speed clock OSCL, in Hz.
+ *
+ * Follows CSWCFGR.OSCL_SEL_ST: 128 kHz from PMU128K or 32768 Hz from RTC32K.
+ *
+ * @return Frequency in Hz, or 0 while the mux reports no source.
+ */
+uint32_t ft9001_cpm_oscl_freq_hz_get(void);
+
+/**
+ * @brief Switch the low-speed clock OSCL and wait for the switch to complete.
+ *
+ * Starts the requested oscillator, waits for it to be stable, programs
+ * CSWCFGR.OSCL_SEL and waits for OSCL_SEL_ST to follow; the previous source
+ * keeps running. Keep the new source running through sleep with
+ * ft9001_sleep_osc_keep_set() if the wake-up depends on it.
+ *
+ * @param  source      Target source.
+ * @param  timeout_us  Time allowed for the whole switch in microseconds, or
+ *                     @ref FT9001_TICK_FOREVER.
+ * @retval 0           Switched.
+ * @retval -EINVAL     Unknown source.
+ * @retval -ETIMEDOUT  Deadline passed waiting for stability or for the switch.
+ * @retval -EBUSY      Another reconfiguration holds the CPM.
+ */
+int ft9001_cpm_oscl_source_set(enum ft9001_cpm_oscl_source source, uint32_t timeout_us);
+
+/** @brief Read back the selected OSCL source (CSWCFGR.OSCL_SEL). */
+enum ft9001_cpm_oscl_source ft9001_cpm_oscl_source_get(void);
+
 /**
  * @brief Switch the system clock source and wait for the switch to complete.
  *
@@ -70,50 +387,384 @@ int ft9001_cpm_hsosc_trim_set(enum ft9001_cpm_osc_freq freq);
  * Selecting @ref FT9001_CPM_SYSCLK_OSC400M assumes a valid trim has already been
  * programmed by @ref ft9001_cpm_hsosc_trim_set.
  *
+ * The clock-tree model is refreshed afterwards, including on timeout, since a
+ * partial switch may already have taken effect.
+ *
+ * Both waits run against one deadline on the core tick (see ft9001_tick.h),
+ * which keeps counting at OSC8M while the system clock changes under it. The
+ * pre-change callbacks run between them and are not charged to it. How
+ * long each wait took is available from @ref ft9001_cpm_sysclk_switch_time_get.
+ * Same as @ref ft9001_cpm_sysclk_switch_start followed at once by
+ * @ref ft9001_cpm_sysclk_switch_complete.
+ *
  * @param  source      Target clock source.
- * @param  poll_budget Number of register reads to attempt before giving up, or
- *                     @ref FT9001_CPM_POLL_FOREVER. This is a retry count and
- *                     not a duration: the routine runs while the system clock is
- *                     being reconfigured, so the wall-clock time per read varies
- *                     with the current frequency and with the optimisation level
- *                     the HAL was built at.
+ * @param  timeout_us  Time allowed for the whole switch in microseconds, or
+ *                     @ref FT9001_TICK_FOREVER.
  * @retval 0           Source stable and switch complete.
  * @retval -EINVAL     Unsupported source.
- * @retval -ETIMEDOUT  Budget exhausted waiting for stability or for the switch.
+ * @retval -ETIMEDOUT  Deadline passed waiting for stability or for the switch.
+ * @retval -EBUSY      Another reconfiguration holds the CPM.
+ */
+int ft9001_cpm_sysclk_source_set(enum ft9001_cpm_sysclk_source source, uint32_t timeout_us);
+
+/** @brief Measured timing of a system clock switch. */
+struct ft9001_cpm_switch_time {
+	/** From the source enable to its STABLE flag, in microseconds. */
+	uint32_t stable_us;
+	/** From the SYS_SEL write to the matching SYS_SEL_ST, in microseconds. */
+	uint32_t select_us;
+};
+
+/**
+ * @brief Read how long the last system clock switch took.
+ *
+ * Covers every switch the HAL makes, including the one ahead of a trim write.
+ * After a timeout, the failed wait holds the time until the deadline and any
+ * wait not reached holds 0.
  */
-int ft9001_cpm_sysclk_source_set(enum ft9001_cpm_sysclk_source source, uint32_t poll_budget);
+void ft9001_cpm_sysclk_switch_time_get(struct ft9001_cpm_switch_time *t);
+
+/** @brief Progress of an asynchronous system clock switch. */
+enum ft9001_cpm_switch_state {
+	/** The source is enabled; its STABLE flag is not up yet. */
+	FT9001_CPM_SWITCH_STABILISING = 0,
+	/** The source is stable; committing it will not wait on the oscillator. */
+	FT9001_CPM_SWITCH_READY,
+	/** Committed or failed; the result is final. */
+	FT9001_CPM_SWITCH_DONE,
+};
+
+/**
+ * @brief Switch completion callback.
+ *
+ * Runs from the poll or complete call that finished the switch, after the
+ * clock-tree model and the clock listeners have been updated and the CPM has
+ * been released, so it may start the next change.
+ *
+ * @param result    0, or the error the switch ended with.
+ * @param user_data Pointer given in the switch object.
+ */
+typedef void (*ft9001_cpm_switch_cb_t)(int result, void *user_data);
+
+/**
+ * @brief Asynchronous system clock switch.
+ *
+ * Storage belongs to the caller and must stay valid until the switch is done.
+ * Only @p cb and @p user_data are filled in by the caller, before
+ * @ref ft9001_cpm_sysclk_switch_start; @p cb may be NULL.
+ */
+struct ft9001_cpm_switch {
+	ft9001_cpm_switch_cb_t cb;
+	void *user_data;
+	/* Private. */
+	enum ft9001_cpm_sysclk_source source;
+	enum ft9001_cpm_switch_state state;
+	struct ft9001_deadline dl;
+	int result;
+};
+
+/**
+ * @brief Start a system clock switch without waiting for it.
+ *
+ * Enables the target source and returns at once, so other boot work can run
+ * while the oscillator stabilises. Drive the switch to its end with
+ * @ref ft9001_cpm_sysclk_switch_poll or @ref ft9001_cpm_sysclk_switch_complete.
+ * The CPM stays claimed until the switch is done, so other reconfigurations
+ * fail with -EBUSY meanwhile.
+ *
+ * @param  sw         Switch object.
+ * @param  source     Target clock source.
+ * @param  timeout_us Time allowed from now to the end of the switch, or
+ *                    @ref FT9001_TICK_FOREVER.
+ * @retval 0          Started.
+ * @retval -EINVAL    Unsupported source.
+ * @retval -EBUSY     Another reconfiguration holds the CPM.
+ */
+int ft9001_cpm_sysclk_switch_start(struct ft9001_cpm_switch *sw,
+				   enum ft9001_cpm_sysclk_source source, uint32_t timeout_us);
+
+/**
+ * @brief Check on a started switch without blocking.
+ *
+ * Without a callback the switch stops at @ref FT9001_CPM_SWITCH_READY and
+ * waits for @ref ft9001_cpm_sysclk_switch_complete. With one, the first poll
+ * that sees the source stable commits the switch and runs the callback.
+ *
+ * @retval -EINPROGRESS The source is not stable yet.
+ * @retval 0            Ready to commit, or, with a callback, switched.
+ * @retval -ETIMEDOUT   The deadline passed first; the callback has run.
+ */
+int ft9001_cpm_sysclk_switch_poll(struct ft9001_cpm_switch *sw);
+
+/**
+ * @brief Commit a started switch, waiting for whatever is left of it.
+ *
+ * Blocks until the source is stable and CSWCFGR.SYS_SEL_ST follows, within the
+ * deadline given at start. Runs the callback, if any. Calling it again returns
+ * the same result.
+ *
+ * @retval 0          Switched.
+ * @retval -ETIMEDOUT The deadline passed waiting for stability or for the
+ *                    switch.
+ */
+int ft9001_cpm_sysclk_switch_complete(struct ft9001_cpm_switch *sw);
 
 /** @brief Read back the active system clock source (CSWCFGR.SYS_SEL). */
 enum ft9001_cpm_sysclk_source ft9001_cpm_sysclk_source_get(void);
 
+/**
+ * @brief Highest core clock (SYS domain) a clock plan may give, in Hz.
+ *
+ * From CONFIG_FT9001_SYSCLK_MAX_HZ; AHB3, ARITH, TRACE and the I2S clocks
+ * divide it down and are bounded by it.
+ */
+#ifdef CONFIG_FT9001_SYSCLK_MAX_HZ
+#define FT9001_CPM_SYS_MAX_HZ ((uint32_t)CONFIG_FT9001_SYSCLK_MAX_HZ)
+#else
+#define FT9001_CPM_SYS_MAX_HZ (200000000UL)
+#endif
+
+/**
+ * @brief Highest IPS bus clock a clock plan may give, in Hz.
+ *
+ * From CONFIG_FT9001_IPSCLK_MAX_HZ; TC, ADC, MCC and MESH divide it down and
+ * are bounded by it.
+ */
+#ifdef CONFIG_FT9001_IPSCLK_MAX_HZ
+#define FT9001_CPM_IPS_MAX_HZ ((uint32_t)CONFIG_FT9001_IPSCLK_MAX_HZ)
+#else
+#define FT9001_CPM_IPS_MAX_HZ (100000000UL)
+#endif
+
+/**
+ * @brief Every bus and peripheral divider, as raw register fields.
+ *
+ * The effective divide factor of each field is (field + 1). A divider whose
+ * CDIVENR enable is clear reads back as 0; applying a plan enables them all.
+ * CLKOUT_DIV is not part of the plan; see ft9001_cpm_clkout.h.
+ */
+struct ft9001_cpm_clk_plan {
+	/** SCDIVR.SYS_DIV, 8 bits. */
+	uint32_t sys_div;
+	/** SCDIVR.TRACE_DIV, 8 bits. */
+	uint32_t trace_div;
+	/** PCDIVR1.AHB3_DIV, 4 bits. */
+	uint32_t ahb3_div;
+	/** PCDIVR1.ARITH_DIV, 4 bits. */
+	uint32_t arith_div;
+	/** PCDIVR1.IPS_DIV, 4 bits. */
+	uint32_t ips_div;
+	/** PCDIVR2.TC_DIV, 4 bits. */
+	uint32_t tc_div;
+	/** PCDIVR2.ADC_DIV, 4 bits. */
+	uint32_t adc_div;
+	/** PCDIVR2.MCC_DIV, 4 bits. */
+	uint32_t mcc_div;
+	/** PCDIVR2.MESH_DIV, 4 bits. */
+	uint32_t mesh_div;
+	/** PCDIVR4.I2S_M_DIV, 8 bits. */
+	uint32_t i2s_m_div;
+	/** PCDIVR4.I2S_S_DIV, 8 bits. */
+	uint32_t i2s_s_div;
+};
+
+/**
+ * @brief Read the dividers in effect, as the starting point of a new plan.
+ */
+void ft9001_cpm_clk_plan_get(struct ft9001_cpm_clk_plan *plan);
+
+/**
+ * @brief A clock plan packed into its divider registers.
+ *
+ * Only the plan fields are used; CLKOUT_DIV in @p scdivr is ignored. Lets a
+ * plan fixed at build time be packed by the preprocessor, see
+ * ft9001_boot_plan.h.
+ */
+struct ft9001_cpm_clk_regs {
+	uint32_t scdivr;
+	uint32_t pcdivr1;
+	uint32_t pcdivr2;
+	uint32_t pcdivr4;
+};
+
+/**
+ * @brief Check a plan against the field widths and the domain maxima.
+ *
+ * @param  plan    Plan to check.
+ * @param  src_hz  System clock source frequency to check the plan on, or 0 for
+ *                 the current one as the clock-tree model sees it. Lets a
+ *                 caller vet a plan for a source it is about to switch to.
+ * @param  hz      If not NULL, receives the resulting frequency of every domain,
+ *                 unless the result is -EINVAL. CLKOUT is reported at its
+ *                 current setting.
+ * @retval 0       Every field fits and no domain exceeds its maximum.
+ * @retval -EINVAL A field too wide for its register.
+ * @retval -ERANGE The SYS or IPS clock would exceed @ref FT9001_CPM_SYS_MAX_HZ
+ *                 or @ref FT9001_CPM_IPS_MAX_HZ.
+ */
+int ft9001_cpm_clk_plan_check(const struct ft9001_cpm_clk_plan *plan, uint32_t src_hz,
+			      uint32_t hz[FT9001_CPM_CLK_COUNT]);
+
+/**
+ * @brief Commit a plan with a single divider update.
+ *
+ * Checks the plan against the current source, enables every divider, stages
+ * all of SCDIVR, PCDIVR1, PCDIVR2 and PCDIVR4, then latches them with one
+ * CDIVUPDR write of SYSDIV_UPD and PERDIV_UPD, so no domain passes through an
+ * intermediate rate. Enabling a divider before the update only ever slows its
+ * domain down. Refreshes the clock-tree model.
+ *
+ * Nothing is written if the check fails.
+ *
+ * @retval 0       Committed.
+ * @retval -EINVAL A field too wide for its register.
+ * @retval -ERANGE The SYS or IPS clock would exceed its maximum.
+ * @retval -EBUSY  Another reconfiguration holds the CPM.
+ */
+int ft9001_cpm_clk_plan_apply(const struct ft9001_cpm_clk_plan *plan);
+
+/**
+ * @brief Commit packed divider registers without checking them.
+ *
+ * Same single-update sequence as @ref ft9001_cpm_clk_plan_apply, for plans
+ * already checked at build time. Refreshes the clock-tree model.
+ *
+ * @retval 0      Committed.
+ * @retval -EBUSY Another reconfiguration holds the CPM.
+ */
+int ft9001_cpm_clk_regs_write(const struct ft9001_cpm_clk_regs *regs);
+
 /**
  * @brief Set the IPS bus divider (PCDIVR1.IPS_DIV) and commit it.
  *
+ * Shorthand for @ref ft9001_cpm_clk_plan_apply on the current plan with the
+ * IPS divider replaced, read and committed under one claim.
+ *
  * @param  div     Raw 4-bit field; the effective divide factor is (div + 1).
- * @retval 0       Divider programmed and update triggered.
+ * @retval 0       Committed.
  * @retval -EINVAL Divider out of range.
+ * @retval -ERANGE The IPS clock would exceed @ref FT9001_CPM_IPS_MAX_HZ.
+ * @retval -EBUSY  Another reconfiguration holds the CPM.
  */
 int ft9001_cpm_ips_div_set(uint32_t div);
 
 /**
- * @brief Compute the core clock (HCLK) in Hz.
+ * @brief Set the system and IPS dividers together and commit them with one update.
  *
- * Takes the base frequency from the active source (8 MHz for OSC8M, otherwise
- * the nominal frequency recorded by the last successful
- * @ref ft9001_cpm_hsosc_trim_set) and divides it by (SCDIVR.SYS_DIV + 1).
+ * Shorthand for @ref ft9001_cpm_clk_plan_apply on the current plan with both
+ * dividers replaced, so the bus never runs with one new and one old divider.
  *
- * This is a software estimate: it assumes the OTP trim and SCDIVR reflect the
- * current hardware state, and it does not account for external clock sources.
+ * @param  sys_div Raw 8-bit SCDIVR.SYS_DIV field.
+ * @param  ips_div Raw 4-bit PCDIVR1.IPS_DIV field.
+ * @retval 0       Committed.
+ * @retval -EINVAL A divider out of range.
+ * @retval -ERANGE The SYS or IPS clock would exceed its maximum.
+ * @retval -EBUSY  Another reconfiguration holds the CPM.
  */
-uint32_t ft9001_cpm_sysclk_freq_hz_get(void);
+int ft9001_cpm_sys_ips_div_set(uint32_t sys_div, uint32_t ips_div);
+
+/** @brief Read the raw SCDIVR.SYS_DIV field. */
+uint32_t ft9001_cpm_sys_div_get(void);
+
+/** @brief Read the raw PCDIVR1.IPS_DIV field, or 0 while the divider is disabled. */
+uint32_t ft9001_cpm_ips_div_get(void);
 
 /**
- * @brief Compute the IPS bus clock in Hz.
+ * @brief Read one domain frequency from the clock-tree model, in Hz.
  *
- * The SCI baud rate generator and the timers run from this, not from the core
- * clock. Shares the software-estimate caveat of @ref ft9001_cpm_sysclk_freq_hz_get.
+ * The model is built from the CPM registers on first use and then kept up to
+ * date by the setters in this file; the read itself does not touch the bus.
+ * The SYS base frequency is 8 MHz for OSC8M, otherwise
+ * @ref ft9001_cpm_hsosc_freq_hz_get.
+ *
+ * This is a software estimate: unless @ref ft9001_cpm_hsosc_calibrate has run it
+ * assumes the OTP trim reflects the real oscillator, and it does not see
+ * changes made to the CPM registers behind the HAL's back. Call
+ * @ref ft9001_cpm_clk_tree_refresh after such changes.
+ *
+ * @return Frequency in Hz, or 0 for an unknown domain or a source the model
+ *         cannot estimate.
  */
-uint32_t ft9001_cpm_ips_freq_hz_get(void);
+uint32_t ft9001_cpm_clk_freq_hz_get(enum ft9001_cpm_clk clk);
+
+/**
+ * @brief Rebuild the clock-tree model from the CPM registers.
+ *
+ * Notifies listeners of any domain whose frequency differs from the previous
+ * model and updates SystemCoreClock when the HAL provides it. The setters in
+ * this file already do this; it is only needed after writing the CPM
+ * registers directly.
+ */
+void ft9001_cpm_clk_tree_refresh(void);
+
+/**
+ * @brief Subscribe to clock changes.
+ *
+ * Listeners are called in registration order.
+ *
+ * @retval 0         Registered.
+ * @retval -EINVAL   Neither callback set.
+ * @retval -EALREADY Already registered.
+ */
+int ft9001_cpm_clk_listener_register(struct ft9001_cpm_clk_listener *listener);
+
+/**
+ * @brief Cancel a subscription.
+ *
+ * @retval 0       Removed.
+ * @retval -ENOENT Not registered.
+ */
+int ft9001_cpm_clk_listener_unregister(struct ft9001_cpm_clk_listener *listener);
+
+/** @brief The listener is currently registered. */
+bool ft9001_cpm_clk_listener_is_registered(const struct ft9001_cpm_clk_listener *listener);
+
+#ifdef CONFIG_FT9001_CLOCK_PLAN_FIXED
+/**
+ * @brief The system clock runs from the boot plan's source.
+ *
+ * SystemInit() only misses it when the trim is absent from OTP or the switch
+ * timed out, and nothing moves the clock afterwards, so this tells whether
+ * the build-time frequencies hold.
+ */
+static inline bool ft9001_cpm_boot_plan_held(void)
+{
+	return ft9001_cpm_sysclk_source_get() == FT9001_BOOT_SYSCLK;
+}
+#endif
+
+/**
+ * @brief Core clock (HCLK) in Hz, from the clock-tree model.
+ *
+ * With CONFIG_FT9001_CLOCK_PLAN_FIXED, the build-time constant as long as
+ * @ref ft9001_cpm_boot_plan_held; the model otherwise.
+ */
+static inline uint32_t ft9001_cpm_sysclk_freq_hz_get(void)
+{
+#ifdef CONFIG_FT9001_CLOCK_PLAN_FIXED
+	if (ft9001_cpm_boot_plan_held()) {
+		return FT9001_BOOT_SYS_HZ;
+	}
+#endif
+	return ft9001_cpm_clk_freq_hz_get(FT9001_CPM_CLK_SYS);
+}
+
+/**
+ * @brief IPS bus clock in Hz, from the clock-tree model.
+ *
+ * The SCI baud rate generator runs from this, not from the core clock. With
+ * CONFIG_FT9001_CLOCK_PLAN_FIXED, the build-time constant as long as
+ * @ref ft9001_cpm_boot_plan_held; the model otherwise.
+ */
+static inline uint32_t ft9001_cpm_ips_freq_hz_get(void)
+{
+#ifdef CONFIG_FT9001_CLOCK_PLAN_FIXED
+	if (ft9001_cpm_boot_plan_held()) {
+		return FT9001_BOOT_IPS_HZ;
+	}
+#endif
+	return ft9001_cpm_clk_freq_hz_get(FT9001_CPM_CLK_IPS);
+}
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2026, FocalTech Systems CO.,Ltd
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file    ft9001_cpm_clkout.h
+ * @brief   FT9001 CLKOUT pin routing, for measuring internal clocks on the bench.
+ *
+ * CSWCFGR.CLKOUT_SEL picks the source, SCDIVR.CLKOUT_DIV divides it when
+ * CDIVENR.CLKOUT_DIVEN is set. The frequency the HAL expects on the pin comes
+ * from the clock-tree model (@ref FT9001_CPM_CLK_CLKOUT), so a fixture that
+ * counts the pin can check the model, and through it the OTP trim or the last
+ * calibration, against the real oscillator.
+ *
+ * The pin function itself is selected in the pin controller, outside this HAL.
+ */
+
+#ifndef FT9001_CPM_CLKOUT_H_
+#define FT9001_CPM_CLKOUT_H_
+
+#include <stdint.h>
+
+#include "ft9001.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief CLKOUT sources, encoded as CSWCFGR.CLKOUT_SEL. */
+enum ft9001_cpm_clkout_src {
+	/** System clock. */
+	FT9001_CPM_CLKOUT_SYS = 0,
+	/** Arithmetic-unit clock. */
+	FT9001_CPM_CLKOUT_ARITH,
+	/** NFC PLL output. */
+	FT9001_CPM_CLKOUT_PLLNFC,
+	/** Low-speed clock OSCL. */
+	FT9001_CPM_CLKOUT_OSCL,
+	FT9001_CPM_CLKOUT_COUNT,
+};
+
+/** @brief Largest CLKOUT_DIV field; the divide factor is the field plus one. */
+#define FT9001_CPM_CLKOUT_DIV_MAX (0xFFUL)
+
+/**
+ * @brief Route a source to CLKOUT through a divider.
+ *
+ * Waits for CSWCFGR.CLKOUT_SEL_ST to confirm the source, which only happens
+ * while that source is running.
+ *
+ * @param  src        Source to export.
+ * @param  div        Raw CLKOUT_DIV field; the source is divided by @p div + 1.
+ * @param  out_hz     If not NULL, receives the frequency the model expects on
+ *                    the pin; 0 if the model cannot estimate the source.
+ * @retval 0          Routed.
+ * @retval -EINVAL    Unknown source or divider out of range.
+ * @retval -ETIMEDOUT The mux did not confirm the source, which is usually not
+ *                    running. The selection and divider are left programmed.
+ */
+int ft9001_cpm_clkout_set(enum ft9001_cpm_clkout_src src, uint32_t div, uint32_t *out_hz);
+
+/**
+ * @brief Route a source to CLKOUT at or below a frequency limit.
+ *
+ * Picks the smallest divider that keeps the modelled output at or below
+ * @p max_hz, e.g. the bandwidth of the pad or of the fixture's counter.
+ *
+ * @param  src        Source to export.
+ * @param  max_hz     Highest acceptable output frequency.
+ * @param  out_hz     If not NULL, receives the expected output frequency.
+ * @retval 0          Routed.
+ * @retval -EINVAL    Unknown source or zero @p max_hz.
+ * @retval -ENODATA   The model has no frequency for the source.
+ * @retval -ERANGE    Even the largest divider leaves the output above
+ *                    @p max_hz; nothing was changed.
+ * @retval -ETIMEDOUT See @ref ft9001_cpm_clkout_set.
+ */
+int ft9001_cpm_clkout_hz_set(enum ft9001_cpm_clkout_src src, uint32_t max_hz,
+			     uint32_t *out_hz);
+
+/**
+ * @brief Read back the routed source and divider.
+ *
+ * @param div Receives the raw CLKOUT_DIV field, or 0 while the divider is
+ *            disabled.
+ * @return The source selected in CSWCFGR.CLKOUT_SEL.
+ */
+enum ft9001_cpm_clkout_src ft9001_cpm_clkout_get(uint32_t *div);
+
+/**
+ * @brief Compare a frequency measured on the pin with the model.
+ *
+ * @param  measured_hz What the fixture counted.
+ * @param  err_ppm     Receives (measured - expected) / expected, in ppm.
+ * @retval 0           Compared.
+ * @retval -ENODATA    The model has no frequency for the routed source.
+ */
+int ft9001_cpm_clkout_error_ppm(uint32_t measured_hz, int32_t *err_ppm);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FT9001_CPM_CLKOUT_H_ */
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2026, FocalTech Systems CO.,Ltd
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file    ft9001_cpm_stime.h
+ * @brief   FT9001 oscillator stable-time measurement and programming.
+ *
+ * After an oscillator is enabled, and again whenever it restarts on wake-up,
+ * the CPM holds its STABLE flag back for the time programmed in OSCLSTIMER,
+ * OSCHSTIMER, OSCESTIMER or RTCSTIMER. Anything clocked from that oscillator
+ * waits that long, so a conservative value lands directly in the wake-up
+ * latency.
+ *
+ * @ref ft9001_cpm_stime_tune measures how long the oscillator actually takes on
+ * this part and programs that plus a margin, but never less than the reset
+ * default.
+ */
+
+#ifndef FT9001_CPM_STIME_H_
+#define FT9001_CPM_STIME_H_
+
+#include <stdint.h>
+
+#include "ft9001.h"
+#include "ft9001_cpm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Programmed stable time of an oscillator, in microseconds.
+ *
+ * Rounded up to a whole microsecond; 0 for an unknown oscillator.
+ */
+uint32_t ft9001_cpm_stime_us_get(enum ft9001_cpm_osc osc);
+
+/**
+ * @brief Program the stable time of an oscillator.
+ *
+ * @retval 0       Programmed.
+ * @retval -EINVAL Unknown oscillator, or longer than the register can hold.
+ */
+int ft9001_cpm_stime_us_set(enum ft9001_cpm_osc osc, uint32_t us);
+
+/**
+ * @brief Measure how long an oscillator takes to settle on this part.
+ *
+ * Powers the oscillator down, then times the interval from its enable to its
+ * own ready indication with the stable timer set to zero. The TC block serves
+ * as the time base. The oscillator's enable and stable-time settings and the
+ * TC settings are restored afterwards.
+ *
+ * The oscillator must be idle: the high-speed oscillator may not be the system
+ * clock, and PMU128K or RTC32K may not be the selected OSCL source.
+ *
+ * @param  osc        Oscillator to measure.
+ * @param  settle_us  Receives the settle time, in microseconds.
+ * @retval 0          Measured.
+ * @retval -EINVAL    Unknown oscillator.
+ * @retval -EBUSY     The oscillator is in use, or another reconfiguration
+ *                    holds the CPM.
+ * @retval -ETIMEDOUT The oscillator did not stop, or did not come up within
+ *                    the longest programmable stable time.
+ */
+int ft9001_cpm_osc_settle_measure(enum ft9001_cpm_osc osc, uint32_t *settle_us);
+
+/**
+ * @brief Measure an oscillator and program its stable time with a margin.
+ *
+ * The measurement takes the STABLE flag, with the stable timer at zero, as the
+ * oscillator's own ready indication. The register documentation available does
+ * not confirm that behaviour, so the result is floored at the stable time the
+ * oscillator had out of reset: tuning can lengthen a stable time that proves
+ * too short on this part, never cut below the default. A shorter value can
+ * still be programmed through @ref ft9001_cpm_stime_us_set once validated on
+ * the board, from @ref ft9001_cpm_osc_settle_measure.
+ *
+ * @param  osc        Oscillator to tune.
+ * @param  margin_pct Safety margin on top of the measurement, in percent.
+ * @param  stime_us   If not NULL, receives the programmed stable time, which is
+ *                    what a wake-up from that oscillator now costs.
+ * @retval 0          Programmed.
+ * @retval -EINVAL    Unknown oscillator, or the result does not fit the
+ *                    register.
+ * @retval -EBUSY     The oscillator is in use, or another reconfiguration
+ *                    holds the CPM.
+ * @retval -ETIMEDOUT The measurement failed; the stable time is unchanged.
+ */
+int ft9001_cpm_stime_tune(enum ft9001_cpm_osc osc, uint32_t margin_pct, uint32_t *stime_us);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FT9001_CPM_STIME_H_ */
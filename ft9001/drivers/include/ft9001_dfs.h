@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2026, FocalTech Systems CO.,Ltd
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file    ft9001_dfs.h
+ * @brief   FT9001 dynamic frequency scaling across named operating points.
+ *
+ * Each level fixes the system clock source, the high-speed oscillator trim and
+ * the SYS/IPS dividers. A transition only performs the steps whose target
+ * differs from the current state: an unchanged trim is not reloaded, an
+ * unchanged source is not switched and unchanged dividers are not rewritten.
+ *
+ * Peripherals follow through the CPM clock listeners; UARTs registered with
+ * @ref ft9001_dfs_uart_register have their transmitter drained before the IPS
+ * clock moves and their baud divisor re-derived after, intermediate steps
+ * included.
+ *
+ * Not re-entrant. The CPM routines underneath guard themselves, so a
+ * transition racing another CPM reconfiguration fails with -EBUSY instead of
+ * interleaving with it.
+ */
+
+#ifndef FT9001_DFS_H_
+#define FT9001_DFS_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "ft9001.h"
+#include "ft9001_cpm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Longest wait for a registered UART to drain before its clock moves, in
+ *        microseconds.
+ *
+ * A full FIFO at 9600 baud, with margin. Each IPS clock change may spend this
+ * much per registered UART, with the CPM claimed.
+ */
+#define FT9001_DFS_UART_DRAIN_MAX_US (20000U)
+
+/** @brief Performance levels, slowest first. */
+enum ft9001_dfs_level {
+	/** OSC8M, high-speed oscillator powered down. */
+	FT9001_DFS_LEVEL_IDLE = 0,
+	/** High-speed oscillator trimmed to 320 MHz. */
+	FT9001_DFS_LEVEL_NOMINAL,
+	/** High-speed oscillator trimmed to 400 MHz. */
+	FT9001_DFS_LEVEL_BOOST,
+	FT9001_DFS_LEVEL_COUNT,
+};
+
+/** @brief Operating point behind a level. */
+struct ft9001_dfs_opp {
+	/** Printable name. */
+	const char *name;
+	enum ft9001_cpm_sysclk_source source;
+	/** Trim to load; ignored when @p source is OSC8M. */
+	enum ft9001_cpm_osc_freq hsosc_freq;
+	/** Raw SCDIVR.SYS_DIV field. */
+	uint32_t sys_div;
+	/** Raw PCDIVR1.IPS_DIV field. */
+	uint32_t ips_div;
+	/** Power the high-speed oscillator down while at this level. */
+	bool hsosc_off;
+};
+
+/** @brief A UART whose baud rate is held across clock changes. */
+struct ft9001_dfs_uart {
+	UART_TypeDef *inst;
+	uint32_t baudrate;
+	/** Result of the last divisor update, 0 or a negative errno. */
+	int err;
+	/* Private. */
+	struct ft9001_cpm_clk_listener listener;
+};
+
+/** @brief Look up the operating point of a level, or NULL if out of range. */
+const struct ft9001_dfs_opp *ft9001_dfs_opp_get(enum ft9001_dfs_level level);
+
+/**
+ * @brief The level can be reached on this part.
+ *
+ * False for a level whose trim is missing from OTP, such as
+ * @ref FT9001_DFS_LEVEL_BOOST on parts without a 400 MHz trim.
+ */
+bool ft9001_dfs_level_available(enum ft9001_dfs_level level);
+
+/**
+ * @brief Move to a performance level.
+ *
+ * Steps already in the target state are skipped. Dividers are raised before
+ * the clock speeds up and lowered after it slows down, and SYS/IPS are always
+ * committed together as one clock plan, checked before anything is changed.
+ *
+ * If a step fails, the steps back to the operating point in force before the
+ * call are run the same way and the first error is returned. Should one of
+ * those fail too, or the hardware start from a point that cannot be restored
+ * (the high-speed oscillator running on a trim the HAL did not load), the
+ * clock is left after the last step that succeeded: every step leaves a
+ * consistent clock tree and the CPM listeners have seen it, but
+ * @ref ft9001_dfs_level_get may match no level.
+ *
+ * @param  level      Target level.
+ * @param  latency_us If not NULL, receives the time the steps actually took,
+ *                    measured on the core tick, in microseconds. This includes
+ *                    the UART drains before each IPS change, up to
+ *                    @ref FT9001_DFS_UART_DRAIN_MAX_US per registered UART.
+ *                    Also set when a step fails, as the time until the
+ *                    failure, before any rollback.
+ * @retval 0          At the target level.
+ * @retval -EINVAL    Unknown level.
+ * @retval -ENOENT    The level's trim is not in OTP.
+ * @retval -ERANGE    The level's SYS or IPS clock exceeds the configured
+ *                    maximum; nothing was changed.
+ * @retval -ETIMEDOUT An oscillator or the source switch did not settle.
+ * @retval -EBUSY     Another CPM reconfiguration was in progress.
+ */
+int ft9001_dfs_level_set(enum ft9001_dfs_level level, uint32_t *latency_us);
+
+/**
+ * @brief Read back the current level.
+ *
+ * @retval level                 The hardware matches that level's operating point.
+ * @retval FT9001_DFS_LEVEL_COUNT The clock configuration matches no level.
+ */
+enum ft9001_dfs_level ft9001_dfs_level_get(void);
+
+/**
+ * @brief Estimate the cost of a transition without performing it.
+ *
+ * Selects steps the same way as @ref ft9001_dfs_level_set, starting from the
+ * current hardware state, and charges each its worst-case cost. Intended for
+ * governors weighing whether a switch pays off. UART drains are not included;
+ * see @ref FT9001_DFS_UART_DRAIN_MAX_US.
+ *
+ * @return Latency in microseconds, or UINT32_MAX for an unknown level.
+ */
+uint32_t ft9001_dfs_latency_us_estimate(enum ft9001_dfs_level level);
+
+/**
+ * @brief Keep a UART at @p baudrate across clock changes.
+ *
+ * Programs the divisor for the current IPS clock straight away.
+ *
+ * @retval 0         Registered and divisor programmed.
+ * @retval -EALREADY Already registered; the baud rate and instance are left
+ *                   as they were.
+ * @retval -EINVAL   The baud rate is out of reach at the current clock; the
+ *                   UART is still registered and retried on the next change.
+ */
+int ft9001_dfs_uart_register(struct ft9001_dfs_uart *uart, UART_TypeDef *inst,
+			     uint32_t baudrate);
+
+/**
+ * @brief Stop tracking a UART.
+ *
+ * @retval 0       Removed.
+ * @retval -ENOENT Not registered.
+ */
+int ft9001_dfs_uart_unregister(struct ft9001_dfs_uart *uart);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FT9001_DFS_H_ */
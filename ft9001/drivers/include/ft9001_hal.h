@@ -8,8 +8,14 @@
 #define FT9001_HAL_H_
 
 #include "ft9001_cache.h"
+#include "ft9001_cache_bench.h"
 #include "ft9001_cpm.h"
+#include "ft9001_cpm_clkout.h"
+#include "ft9001_cpm_stime.h"
+#include "ft9001_dfs.h"
+#include "ft9001_sleep.h"
 #include "ft9001_tc.h"
+#include "ft9001_tick.h"
 #include "ft9001_uart.h"
 #include "ft9001_wdt.h"
 
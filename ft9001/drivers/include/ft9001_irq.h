@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2026, FocalTech Systems CO.,Ltd
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file    ft9001_irq.h
+ * @brief   FT9001 interrupt masking for short HAL critical sections.
+ *
+ * Masks through PRIMASK and restores the previous state, so sections nest and
+ * are safe to enter from interrupt context. Keep them to a few register
+ * accesses; nothing in the HAL waits inside one. The register helpers below
+ * wrap a single read-modify-write in such a section.
+ */
+
+#ifndef FT9001_IRQ_H_
+#define FT9001_IRQ_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Mask interrupts and return the previous PRIMASK. */
+static inline uint32_t ft9001_irq_lock(void)
+{
+	uint32_t key;
+
+	__asm__ volatile("mrs %0, primask\n\t"
+			 "cpsid i"
+			 : "=r"(key)
+			 :
+			 : "memory");
+
+	return key;
+}
+
+/** @brief Restore the PRIMASK returned by @ref ft9001_irq_lock. */
+static inline void ft9001_irq_unlock(uint32_t key)
+{
+	__asm__ volatile("msr primask, %0" : : "r"(key) : "memory");
+}
+
+/**
+ * @brief Read-modify-write a register with interrupts masked.
+ *
+ * For registers shared between contexts, where a plain FT9001_MODIFY_REG
+ * could be torn by a preempting writer of other bits.
+ */
+static inline void ft9001_irq_reg_modify(volatile uint32_t *reg, uint32_t clear, uint32_t set)
+{
+	uint32_t key = ft9001_irq_lock();
+
+	*reg = (*reg & ~clear) | set;
+
+	ft9001_irq_unlock(key);
+}
+
+/** @brief Set bits in a shared register, see @ref ft9001_irq_reg_modify. */
+static inline void ft9001_irq_reg_set(volatile uint32_t *reg, uint32_t bits)
+{
+	ft9001_irq_reg_modify(reg, 0U, bits);
+}
+
+/** @brief Clear bits in a shared register, see @ref ft9001_irq_reg_modify. */
+static inline void ft9001_irq_reg_clear(volatile uint32_t *reg, uint32_t bits)
+{
+	ft9001_irq_reg_modify(reg, bits, 0U);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FT9001_IRQ_H_ */
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2026, FocalTech Systems CO.,Ltd
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file    ft9001_sleep.h
+ * @brief   FT9001 sleep modes and their entry/exit latencies.
+ *
+ * Three depths, shallowest first: WFI with the bus still clocked, the CPM
+ * low-power mode (SLPCFGR.SLEEP_MODE) with the clocks stopped and state kept,
+ * and hibernation, which loses the core and wakes through reset.
+ *
+ * The latencies are measured rather than budgeted: the entry figure is the
+ * longest @ref ft9001_sleep_prepare and the exit figure the longest
+ * @ref ft9001_sleep_finish seen for the mode so far, timed on the core tick.
+ * Waking low-power sleep also waits out the high-speed oscillator's programmed
+ * stable time (see ft9001_cpm_stime.h) when the system clock runs from it, so
+ * that is added. The CPM's own power-down and wake-up sequencing is not
+ * included; the HAL has no documented figure for it. A mode that was never
+ * entered reports 0 for the measured parts.
+ *
+ * Entry is split into prepare, WFI and finish so that an OS idle path can issue
+ * the WFI itself; @ref ft9001_sleep_enter does all three.
+ */
+
+#ifndef FT9001_SLEEP_H_
+#define FT9001_SLEEP_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "ft9001.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Sleep depths, shallowest first. */
+enum ft9001_sleep_mode {
+	/** Core clock stopped by WFI; buses and oscillators keep running. */
+	FT9001_SLEEP_MODE_WFI = 0,
+	/** CPM low-power sleep: clocks stopped, core and SRAM state kept. */
+	FT9001_SLEEP_MODE_LOW_POWER,
+	/** CPM hibernation: core powered down, wake-up goes through reset. */
+	FT9001_SLEEP_MODE_HIBERNATION,
+	FT9001_SLEEP_MODE_COUNT,
+};
+
+/** @brief Cost of one round trip through a sleep mode. */
+struct ft9001_sleep_latency {
+	/** Longest measured prepare, in microseconds. */
+	uint32_t entry_us;
+	/** Longest measured finish plus the oscillator restart, in microseconds;
+	 *  UINT32_MAX when wake-up goes through reset.
+	 */
+	uint32_t exit_us;
+	/** Shortest idle period for which the mode pays off, in microseconds. */
+	uint32_t min_residency_us;
+	/** Execution resumes after the WFI; false if wake-up goes through reset. */
+	bool retains_state;
+};
+
+/** @brief Keep RTC32K running through sleep. */
+#define FT9001_SLEEP_KEEP_RTC32K  CPM_SLPCFGR_RTC32K_SLPEN
+/** @brief Keep PMU128K running through sleep. */
+#define FT9001_SLEEP_KEEP_PMU128K CPM_SLPCFGR_PMU128K_SLPEN
+/** @brief Keep OSCEXT running through sleep. */
+#define FT9001_SLEEP_KEEP_OSCEXT  CPM_SLPCFGR_OSCEXT_SLPEN
+/** @brief Every oscillator that can be kept. */
+#define FT9001_SLEEP_KEEP_ALL                                                              \
+	(FT9001_SLEEP_KEEP_RTC32K | FT9001_SLEEP_KEEP_PMU128K | FT9001_SLEEP_KEEP_OSCEXT)
+
+/**
+ * @brief Pick the oscillators that keep running in the CPM sleep modes.
+ *
+ * Whatever drives the wake-up timer has to be in the set. The default keeps
+ * RTC32K and PMU128K.
+ *
+ * @param keep FT9001_SLEEP_KEEP_* flags.
+ */
+void ft9001_sleep_osc_keep_set(uint32_t keep);
+
+/** @brief Read the FT9001_SLEEP_KEEP_* set in use. */
+uint32_t ft9001_sleep_osc_keep_get(void);
+
+/**
+ * @brief Look up the latency of a mode under the current configuration.
+ *
+ * @retval 0       @p lat filled in.
+ * @retval -EINVAL Unknown mode.
+ */
+int ft9001_sleep_latency_get(enum ft9001_sleep_mode mode, struct ft9001_sleep_latency *lat);
+
+/**
+ * @brief Pick the deepest state-retaining mode that fits an idle period.
+ *
+ * A mode qualifies when @p idle_us covers its minimum residency and its exit
+ * latency is within @p max_exit_us. Hibernation is never returned.
+ *
+ * @param  idle_us     Time until the next deadline, or UINT32_MAX for none.
+ * @param  max_exit_us Largest tolerable wake-up latency.
+ * @return The selected mode; at least @ref FT9001_SLEEP_MODE_WFI.
+ */
+enum ft9001_sleep_mode ft9001_sleep_mode_select(uint32_t idle_us, uint32_t max_exit_us);
+
+/**
+ * @brief Program the CPM for a mode, up to the point of issuing WFI.
+ *
+ * Must be called with interrupts masked; the caller then executes WFI and
+ * calls @ref ft9001_sleep_finish. With the cache driver built in, the caches
+ * are readied first (see ft9001_cache_sleep_prepare()).
+ *
+ * @retval 0          Ready for WFI.
+ * @retval -EINVAL    Unknown mode.
+ * @retval -ETIMEDOUT A cache clean did not finish; nothing was programmed.
+ */
+int ft9001_sleep_prepare(enum ft9001_sleep_mode mode);
+
+/**
+ * @brief Undo @ref ft9001_sleep_prepare after wake-up.
+ *
+ * Clears SLEEPDEEP and refreshes the clock-tree model, in case the system
+ * clock came back on a different source.
+ */
+void ft9001_sleep_finish(enum ft9001_sleep_mode mode);
+
+/**
+ * @brief Enter a sleep mode and return after wake-up.
+ *
+ * Masks interrupts around prepare, WFI and finish. A pending interrupt still
+ * wakes the core, and is taken once this returns.
+ *
+ * @retval 0       Slept and woke up.
+ * @retval -EINVAL Unknown mode.
+ */
+int ft9001_sleep_enter(enum ft9001_sleep_mode mode);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FT9001_SLEEP_H_ */
@@ -58,6 +58,32 @@ static inline void tc_ccr_modify(TC_TypeDef *inst, uint16_t clear, uint16_t set)
 	FT9001_MODIFY_REG(inst->TCCR, (uint16_t)(clear | TC_TCCR_CMD_Msk), set);
 }
 
+/** @brief TC settings captured by @ref ft9001_tc_save. */
+struct ft9001_tc_ctx {
+	uint16_t tccr;
+	uint16_t tcmr;
+};
+
+/** @brief Capture the control bits and the reload value, to borrow the block. */
+static inline void ft9001_tc_save(TC_TypeDef *inst, struct ft9001_tc_ctx *ctx)
+{
+	ctx->tccr = (uint16_t)(inst->TCCR & (uint16_t)~TC_TCCR_CMD_Msk);
+	ctx->tcmr = inst->TCMR;
+}
+
+/**
+ * @brief Put back what @ref ft9001_tc_save captured.
+ *
+ * The counter itself cannot be written: it reloads from the restored modulus,
+ * and a timer that was running resumes counting from there.
+ */
+static inline void ft9001_tc_restore(TC_TypeDef *inst, const struct ft9001_tc_ctx *ctx)
+{
+	tc_ccr_modify(inst, 0U, (uint16_t)TC_TCCR_STOP);
+	inst->TCMR = ctx->tcmr;
+	tc_ccr_modify(inst, (uint16_t)~TC_TCCR_CMD_Msk, (uint16_t)(ctx->tccr | TC_TCCR_CU));
+}
+
 /** @brief Let the counter run: clear STOP along with the DBG/DOZE/WAIT halts. */
 static inline void ft9001_tc_start(TC_TypeDef *inst)
 {
@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2026, FocalTech Systems CO.,Ltd
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file    ft9001_tick.h
+ * @brief   FT9001 core tick and microsecond deadlines for HAL waits.
+ *
+ * CTICKR counts OSC8M cycles whatever the system clock runs from, so a deadline
+ * taken from it keeps its wall-clock meaning across source switches and
+ * divider changes, and does not depend on how fast the polling loop spins.
+ * OSC8M runs from reset and the HAL never stops it.
+ *
+ * The counter wraps about every 536 s; longer timeouts are clamped to
+ * @ref FT9001_TICK_TIMEOUT_MAX_US.
+ */
+
+#ifndef FT9001_TICK_H_
+#define FT9001_TICK_H_
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ft9001.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief CTICKR counts per microsecond. */
+#define FT9001_TICK_PER_US (8UL)
+
+/** @brief Wait without a deadline; 0, as the poll budgets it replaced used. */
+#define FT9001_TICK_FOREVER 0U
+
+/** @brief Longest finite timeout; one counter wrap. */
+#define FT9001_TICK_TIMEOUT_MAX_US (UINT32_MAX / FT9001_TICK_PER_US)
+
+/** @brief A point in time after which a wait gives up. */
+struct ft9001_deadline {
+	uint32_t start;
+	uint32_t ticks;
+	bool forever;
+};
+
+/** @brief Read the core tick counter. */
+static inline uint32_t ft9001_tick_get(void)
+{
+	return FT9001_READ_REG(CPM->CTICKR);
+}
+
+/** @brief Microseconds elapsed since @p start, a value of @ref ft9001_tick_get. */
+static inline uint32_t ft9001_tick_us_since(uint32_t start)
+{
+	return (ft9001_tick_get() - start) / FT9001_TICK_PER_US;
+}
+
+/**
+ * @brief Start a deadline @p timeout_us from now.
+ *
+ * @param timeout_us Microseconds, or @ref FT9001_TICK_FOREVER.
+ */
+static inline void ft9001_deadline_start(struct ft9001_deadline *dl, uint32_t timeout_us)
+{
+	dl->start = ft9001_tick_get();
+	dl->forever = (timeout_us == FT9001_TICK_FOREVER);
+	if (timeout_us > FT9001_TICK_TIMEOUT_MAX_US) {
+		timeout_us = FT9001_TICK_TIMEOUT_MAX_US;
+	}
+	dl->ticks = timeout_us * FT9001_TICK_PER_US;
+}
+
+/** @brief The deadline has passed; never true for @ref FT9001_TICK_FOREVER. */
+static inline bool ft9001_deadline_expired(const struct ft9001_deadline *dl)
+{
+	return !dl->forever && (uint32_t)(ft9001_tick_get() - dl->start) >= dl->ticks;
+}
+
+/** @brief Microseconds since the deadline was started. */
+static inline uint32_t ft9001_deadline_elapsed_us(const struct ft9001_deadline *dl)
+{
+	return ft9001_tick_us_since(dl->start);
+}
+
+/**
+ * @brief Microseconds left before the deadline.
+ *
+ * @return At least 1 for a finite deadline, even once it has passed, so the
+ *         value can be handed on as the timeout of a following wait without
+ *         turning into @ref FT9001_TICK_FOREVER; @ref FT9001_TICK_FOREVER for an
+ *         open-ended one.
+ */
+static inline uint32_t ft9001_deadline_left_us(const struct ft9001_deadline *dl)
+{
+	uint32_t spent;
+	uint32_t left_us;
+
+	if (dl->forever) {
+		return FT9001_TICK_FOREVER;
+	}
+
+	spent = ft9001_tick_get() - dl->start;
+	left_us = (spent < dl->ticks) ? (dl->ticks - spent) / FT9001_TICK_PER_US : 0U;
+
+	return (left_us != 0U) ? left_us : 1U;
+}
+
+/**
+ * @brief Wait until the bits under @p mask read back as @p value.
+ *
+ * The register is sampled once more after the deadline passes, so a condition
+ * that came true in time is never reported as a timeout.
+ *
+ * @param  reg        Register to poll.
+ * @param  mask       Bits to compare.
+ * @param  value      Expected value of those bits.
+ * @param  timeout_us Microseconds, or @ref FT9001_TICK_FOREVER.
+ * @param  waited_us  If not NULL, receives the time spent waiting, also on
+ *                    timeout.
+ * @retval 0          The bits matched.
+ * @retval -ETIMEDOUT The deadline passed first.
+ */
+static inline int ft9001_tick_wait_bits(volatile uint32_t *reg, uint32_t mask, uint32_t value,
+					uint32_t timeout_us, uint32_t *waited_us)
+{
+	struct ft9001_deadline dl;
+	bool late;
+	int ret;
+
+	ft9001_deadline_start(&dl, timeout_us);
+
+	for (;;) {
+		late = ft9001_deadline_expired(&dl);
+		if (((*reg) & mask) == value) {
+			ret = 0;
+			break;
+		}
+		if (late) {
+			ret = -ETIMEDOUT;
+			break;
+		}
+	}
+
+	if (waited_us != NULL) {
+		*waited_us = ft9001_deadline_elapsed_us(&dl);
+	}
+
+	return ret;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FT9001_TICK_H_ */
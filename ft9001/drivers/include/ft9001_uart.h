@@ -13,7 +13,9 @@
  * and SCIFSR2 (receive errors, write-one-to-clear). Interrupt sources are
  * unmasked in SCIFCR2.
  *
- * Waiting is left to the caller: these routines report state and never block.
+ * Waiting is left to the caller: these routines report state and never block,
+ * except @ref ft9001_uart_tx_drain, which waits against a deadline on the core
+ * tick (see ft9001_tick.h).
  */
 
 #ifndef FT9001_UART_H_
@@ -23,6 +25,7 @@
 #include <stdint.h>
 
 #include "ft9001.h"
+#include "ft9001_tick.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -198,6 +201,18 @@ int ft9001_uart_baudrate_set(UART_TypeDef *inst, uint32_t pclk_hz, uint32_t baud
 int ft9001_uart_configure(UART_TypeDef *inst, const struct ft9001_uart_config *cfg,
 			  uint32_t pclk_hz);
 
+/**
+ * @brief Wait for everything queued for transmission to leave the line.
+ *
+ * Meant for the moment before a baud rate or clock change, which would corrupt
+ * a frame still in flight.
+ *
+ * @param  timeout_us Microseconds, or @ref FT9001_TICK_FOREVER.
+ * @retval 0          TX FIFO and shifter empty.
+ * @retval -ETIMEDOUT Still transmitting when the deadline passed.
+ */
+int ft9001_uart_tx_drain(UART_TypeDef *inst, uint32_t timeout_us);
+
 #ifdef __cplusplus
 }
 #endif
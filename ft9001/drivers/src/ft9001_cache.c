@@ -4,27 +4,82 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <errno.h>
 #include <stdbool.h>
+#include <stddef.h>
+
+#include <cmsis_core.h>
 
 #include "ft9001_cache.h"
+#include "ft9001_tick.h"
+
+#define CACHE_LINE_SIZE FT9001_CACHE_LINE_SIZE
+
+/* CLCR.LCMD line commands. */
+#define CACHE_LCMD_SEARCH (0U)
+#define CACHE_LCMD_PUSH   (2U)
+#define CACHE_LCMD_CLEAR  (3U)
+
+/* Every way command bit of CCR. They stay set once the command is done, so each
+ * command rewrites all of them rather than adding to the previous one.
+ */
+#define CACHE_CCR_CMD_MSK                                                                  \
+	(CACHE_CCR_PUSHW1 | CACHE_CCR_INVW1 | CACHE_CCR_PUSHW0 | CACHE_CCR_INVW0)
+
+/* Largest CPES page operation, in bytes: PAGE_SIZE counts lines. */
+#define CACHE_PAGE_MAX (CACHE_CPES_PAGE_SIZE_Msk)
+
+/* WT_WB bit of every CSACR slot pair. */
+#define CACHE_CSACR_WT_WB_ALL (0x55555555UL)
+
+/* Timeout for a maintenance command. Even a full invalidate takes a few hundred
+ * cycles, so this only trips on a hung engine.
+ */
+#define CACHE_CMD_TIMEOUT_US (1000U)
 
-#define CACHE_LINE_SIZE (16U)
+static uint32_t s_inval_global_min = FT9001_CACHE_INVAL_GLOBAL_MIN_DEFAULT;
 
 static inline bool cache_is_enabled(CACHE_TypeDef *inst)
 {
 	return FT9001_READ_BIT(inst->CACHE_CCR, CACHE_CCR_ENCACHE) != 0U;
 }
 
-static inline void cache_wait_go_clear(CACHE_TypeDef *inst)
+/* CCG.CLK_ENABLE: cleared by ft9001_cache_power_off(), and the engine never
+ * completes a command without it.
+ */
+static inline bool cache_is_clocked(CACHE_TypeDef *inst)
+{
+	return FT9001_READ_BIT(inst->CACHE_CCG, CACHE_CCG_CLK_ENABLE) != 0U;
+}
+
+static inline int cache_wait_go_clear(CACHE_TypeDef *inst)
 {
-	while (FT9001_READ_BIT(inst->CACHE_CCR, CACHE_CCR_GO)) {
+	return ft9001_tick_wait_bits(&inst->CACHE_CCR, CACHE_CCR_GO, 0U, CACHE_CMD_TIMEOUT_US,
+				     NULL);
+}
+
+static inline void cache_cmd_issue(CACHE_TypeDef *inst, uint32_t ccr_bits)
+{
+	FT9001_MODIFY_REG(inst->CACHE_CCR, CACHE_CCR_CMD_MSK, ccr_bits | CACHE_CCR_GO);
+}
+
+/* A gated cache is off and is invalidated before it is clocked again, so a
+ * global command has nothing to do there.
+ */
+static inline int cache_start_cmd(CACHE_TypeDef *inst, uint32_t ccr_bits)
+{
+	if (!cache_is_clocked(inst)) {
+		return 0;
 	}
+
+	cache_cmd_issue(inst, ccr_bits);
+	return cache_wait_go_clear(inst);
 }
 
-static inline void cache_start_cmd(CACHE_TypeDef *inst, uint32_t ccr_bits)
+static inline void cache_page_issue(CACHE_TypeDef *inst, uint32_t base, uint32_t len)
 {
-	FT9001_SET_BIT(inst->CACHE_CCR, ccr_bits | CACHE_CCR_GO);
-	cache_wait_go_clear(inst);
+	FT9001_WRITE_REG(inst->CACHE_CPEA, base);
+	FT9001_WRITE_REG(inst->CACHE_CPES, len | CACHE_CPES_START_INVAL);
 }
 
 static void cache_apply_mode(uint32_t *reg, uint32_t cacheable_mask, uint32_t wt_wb_mask,
@@ -110,6 +165,100 @@ void ft9001_cache_region_mode_set(CACHE_TypeDef *inst, enum ft9001_cache_region
 	}
 }
 
+/* Window registers of a slotted region: four HA words, then four LA words. */
+static volatile uint32_t *cache_slot_regs(CACHE_TypeDef *inst, enum ft9001_cache_region region)
+{
+	switch (region) {
+	case FT9001_CACHE_REGION_BOOT:
+		return &inst->CACHE_CROMRS0HA;
+	case FT9001_CACHE_REGION_SPIM1:
+		return &inst->CACHE_CSPI1S0HA;
+	case FT9001_CACHE_REGION_SPIM2:
+		return &inst->CACHE_CSPI2S0HA;
+	case FT9001_CACHE_REGION_SPIM3:
+		return &inst->CACHE_CSPI3S0HA;
+	default:
+		return NULL;
+	}
+}
+
+/* Position of the WT_WB bit of slot 0 in CSACR; slot n's pair sits 2n above. */
+static uint32_t cache_slot_csacr_pos(enum ft9001_cache_region region)
+{
+	switch (region) {
+	case FT9001_CACHE_REGION_BOOT:
+		return CACHE_CSACR_ROMR_0_WT_WB_Pos;
+	case FT9001_CACHE_REGION_SPIM1:
+		return CACHE_CSACR_SPI1_0_WT_WB_Pos;
+	case FT9001_CACHE_REGION_SPIM2:
+		return CACHE_CSACR_SPI2_0_WT_WB_Pos;
+	case FT9001_CACHE_REGION_SPIM3:
+	default:
+		return CACHE_CSACR_SPI3_0_WT_WB_Pos;
+	}
+}
+
+int ft9001_cache_slot_set(CACHE_TypeDef *inst, enum ft9001_cache_region region, uint32_t slot,
+			  uint32_t addr, uint32_t size, enum ft9001_cache_mode mode)
+{
+	volatile uint32_t *regs = cache_slot_regs(inst, region);
+	uint32_t pos = cache_slot_csacr_pos(region) + (2U * slot);
+	uint32_t off = addr & (FT9001_CACHE_SLOT_SPAN - 1UL);
+
+	if (regs == NULL || slot >= FT9001_CACHE_SLOT_COUNT ||
+	    (addr & (FT9001_CACHE_SLOT_ALIGN - 1UL)) != 0U ||
+	    (size & (FT9001_CACHE_SLOT_ALIGN - 1UL)) != 0U || size == 0U ||
+	    size > FT9001_CACHE_SLOT_SPAN - off) {
+		return -EINVAL;
+	}
+
+	FT9001_CLEAR_BIT(inst->CACHE_CSACR, 0x3UL << pos);
+
+	/* Both bounds are inclusive, in units of the window granularity. */
+	FT9001_WRITE_REG(regs[FT9001_CACHE_SLOT_COUNT + slot],
+			 CACHE_CSPI1S0LA_LOW_ADDRESS_VAL(off / FT9001_CACHE_SLOT_ALIGN));
+	FT9001_WRITE_REG(regs[slot], CACHE_CSPI1S0HA_HIGH_ADDRESS_VAL(
+					     (off + size - 1UL) / FT9001_CACHE_SLOT_ALIGN));
+
+	FT9001_SET_BIT(inst->CACHE_CSACR, (FT9001_CACHE_CSACR_MODE(mode) & 0x3UL) << pos);
+
+	if (!cache_is_enabled(inst)) {
+		return 0;
+	}
+
+	return ft9001_cache_clean_invalidate_all(inst);
+}
+
+int ft9001_cache_slot_get(CACHE_TypeDef *inst, enum ft9001_cache_region region, uint32_t slot,
+			  uint32_t *addr, uint32_t *size, enum ft9001_cache_mode *mode)
+{
+	volatile uint32_t *regs = cache_slot_regs(inst, region);
+	uint32_t pos = cache_slot_csacr_pos(region) + (2U * slot);
+	uint32_t lo;
+	uint32_t hi;
+	uint32_t pair;
+
+	if (regs == NULL || slot >= FT9001_CACHE_SLOT_COUNT) {
+		return -EINVAL;
+	}
+
+	lo = (FT9001_READ_REG(regs[FT9001_CACHE_SLOT_COUNT + slot]) &
+	      CACHE_CSPI1S0LA_LOW_ADDRESS_Msk) >>
+	     CACHE_CSPI1S0LA_LOW_ADDRESS_Pos;
+	hi = (FT9001_READ_REG(regs[slot]) & CACHE_CSPI1S0HA_HIGH_ADDRESS_Msk) >>
+	     CACHE_CSPI1S0HA_HIGH_ADDRESS_Pos;
+	pair = (FT9001_READ_REG(inst->CACHE_CSACR) >> pos) & 0x3UL;
+
+	*addr = lo * FT9001_CACHE_SLOT_ALIGN;
+	*size = (hi >= lo) ? (hi - lo + 1UL) * FT9001_CACHE_SLOT_ALIGN : 0U;
+	/* The pair is CACHEABLE:WT_WB; WT_WB alone does not cache. */
+	*mode = (pair == 0x3UL)   ? FT9001_CACHE_MODE_WRITE_BACK
+		: (pair == 0x2UL) ? FT9001_CACHE_MODE_WRITE_THROUGH
+				  : FT9001_CACHE_MODE_OFF;
+
+	return 0;
+}
+
 void ft9001_cache_regions_configure(CACHE_TypeDef *inst, const struct ft9001_cache_config *cfg)
 {
 	ft9001_cache_region_mode_set(inst, FT9001_CACHE_REGION_BOOT, cfg->boot);
@@ -119,36 +268,478 @@ void ft9001_cache_regions_configure(CACHE_TypeDef *inst, const struct ft9001_cac
 	ft9001_cache_region_mode_set(inst, FT9001_CACHE_REGION_SPIM3, cfg->spim3);
 }
 
-void ft9001_cache_invalidate_all(CACHE_TypeDef *inst)
+int ft9001_cache_invalidate_all(CACHE_TypeDef *inst)
 {
-	cache_start_cmd(inst, CACHE_CCR_INVW1 | CACHE_CCR_INVW0);
+	return cache_start_cmd(inst, CACHE_CCR_INVW1 | CACHE_CCR_INVW0);
 }
 
-void ft9001_cache_invalidate_range(CACHE_TypeDef *inst, uint32_t addr, uint32_t size)
+/* Any region that may hold dirty lines. WT_WB without CACHEABLE does not
+ * cache, but is counted anyway; this only decides against a shortcut.
+ */
+static bool cache_has_write_back(CACHE_TypeDef *inst)
+{
+	return (FT9001_READ_REG(inst->CACHE_CSACR) & CACHE_CSACR_WT_WB_ALL) != 0U ||
+	       FT9001_READ_BIT(inst->CACHE_CACR, CACHE_CACR_ROM_WT_WB | CACHE_CACR_OTP_WT_WB) !=
+		       0U;
+}
+
+static inline bool cache_inval_goes_global(CACHE_TypeDef *inst, uint32_t len)
+{
+	return len >= s_inval_global_min && !cache_has_write_back(inst);
+}
+
+int ft9001_cache_invalidate_range(CACHE_TypeDef *inst, uint32_t addr, uint32_t size)
 {
 	uint32_t base;
 	uint32_t tail;
 	uint32_t len;
+	int ret;
 
 	if (!cache_is_enabled(inst)) {
-		return;
+		return 0;
 	}
 
 	base = addr & ~(CACHE_LINE_SIZE - 1U);
 	tail = (addr - base) + size;
 	len = (tail + (CACHE_LINE_SIZE - 1U)) & ~(CACHE_LINE_SIZE - 1U);
 
-	FT9001_WRITE_REG(inst->CACHE_CPEA, base);
-	FT9001_WRITE_REG(inst->CACHE_CPES, len | CACHE_CPES_START_INVAL);
+	if (cache_inval_goes_global(inst, len)) {
+		return ft9001_cache_invalidate_all(inst);
+	}
+
+	while (len != 0U) {
+		uint32_t chunk = (len > CACHE_PAGE_MAX) ? CACHE_PAGE_MAX : len;
+
+		cache_page_issue(inst, base, chunk);
+
+		ret = ft9001_tick_wait_bits(&inst->CACHE_CPES, CACHE_CPES_START_INVAL, 0U,
+					    CACHE_CMD_TIMEOUT_US, NULL);
+		if (ret != 0) {
+			return ret;
+		}
+
+		base += chunk;
+		len -= chunk;
+	}
+
+	return 0;
+}
+
+void ft9001_cache_inval_global_min_set(uint32_t bytes)
+{
+	s_inval_global_min = bytes;
+}
+
+uint32_t ft9001_cache_inval_global_min_get(void)
+{
+	return s_inval_global_min;
+}
+
+int ft9001_cache_clean_all(CACHE_TypeDef *inst)
+{
+	return cache_start_cmd(inst, CACHE_CCR_PUSHW1 | CACHE_CCR_PUSHW0);
+}
+
+int ft9001_cache_clean_invalidate_all(CACHE_TypeDef *inst)
+{
+	/* With both bits set per way, the engine pushes before it invalidates. */
+	return cache_start_cmd(inst, CACHE_CCR_CMD_MSK);
+}
+
+/* Run one line command over every line of a range, addressed physically: the
+ * command is set up once in CLCR, then each CSAR write with LGO issues it for
+ * one line.
+ */
+static int cache_line_cmd_range(CACHE_TypeDef *inst, uint32_t lcmd, uint32_t addr,
+				uint32_t size)
+{
+	uint32_t base;
+	uint32_t len;
+	int ret;
 
-	while (FT9001_READ_BIT(inst->CACHE_CPES, CACHE_CPES_START_INVAL)) {
+	if (!cache_is_enabled(inst)) {
+		return 0;
+	}
+
+	base = addr & ~(CACHE_LINE_SIZE - 1U);
+	len = ((addr - base) + size + (CACHE_LINE_SIZE - 1U)) & ~(CACHE_LINE_SIZE - 1U);
+
+	FT9001_WRITE_REG(inst->CACHE_CLCR, CACHE_CLCR_LADSEL | CACHE_CLCR_LCMD_VAL(lcmd));
+
+	for (uint32_t off = 0U; off < len; off += CACHE_LINE_SIZE) {
+		FT9001_WRITE_REG(inst->CACHE_CSAR,
+				 ((base + off) & CACHE_CSAR_PHYSICAL_ADDRESS_Msk) | CACHE_CSAR_LGO);
+
+		ret = ft9001_tick_wait_bits(&inst->CACHE_CSAR, CACHE_CSAR_LGO, 0U,
+					    CACHE_CMD_TIMEOUT_US, NULL);
+		if (ret != 0) {
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+int ft9001_cache_clean_range(CACHE_TypeDef *inst, uint32_t addr, uint32_t size)
+{
+	return cache_line_cmd_range(inst, CACHE_LCMD_PUSH, addr, size);
+}
+
+int ft9001_cache_clean_invalidate_range(CACHE_TypeDef *inst, uint32_t addr, uint32_t size)
+{
+	return cache_line_cmd_range(inst, CACHE_LCMD_CLEAR, addr, size);
+}
+
+/* The engine is idle: no global command and no page operation pending. */
+static inline bool cache_idle(CACHE_TypeDef *inst)
+{
+	return FT9001_READ_BIT(inst->CACHE_CCR, CACHE_CCR_GO) == 0U &&
+	       FT9001_READ_BIT(inst->CACHE_CPES, CACHE_CPES_START_INVAL) == 0U;
+}
+
+/* Mark an operation finished without issuing anything. */
+static void cache_op_skip(struct ft9001_cache_op *op, CACHE_TypeDef *inst)
+{
+	op->inst = inst;
+	op->left = 0U;
+	op->result = 0;
+	op->done = true;
+}
+
+static int cache_op_start_global(struct ft9001_cache_op *op, CACHE_TypeDef *inst,
+				 uint32_t ccr_bits, uint32_t timeout_us)
+{
+	if (!cache_is_clocked(inst)) {
+		cache_op_skip(op, inst);
+		return 0;
 	}
+
+	if (!cache_idle(inst)) {
+		return -EBUSY;
+	}
+
+	op->inst = inst;
+	op->next = 0U;
+	op->left = 0U;
+	op->result = 0;
+	op->done = false;
+	ft9001_deadline_start(&op->dl, timeout_us);
+
+	cache_cmd_issue(inst, ccr_bits);
+
+	return 0;
+}
+
+int ft9001_cache_invalidate_all_start(struct ft9001_cache_op *op, CACHE_TypeDef *inst,
+				      uint32_t timeout_us)
+{
+	return cache_op_start_global(op, inst, CACHE_CCR_INVW1 | CACHE_CCR_INVW0, timeout_us);
 }
 
-void ft9001_cache_init(CACHE_TypeDef *inst, const struct ft9001_cache_config *cfg)
+int ft9001_cache_clean_all_start(struct ft9001_cache_op *op, CACHE_TypeDef *inst,
+				 uint32_t timeout_us)
+{
+	return cache_op_start_global(op, inst, CACHE_CCR_PUSHW1 | CACHE_CCR_PUSHW0, timeout_us);
+}
+
+int ft9001_cache_clean_invalidate_all_start(struct ft9001_cache_op *op, CACHE_TypeDef *inst,
+					    uint32_t timeout_us)
+{
+	return cache_op_start_global(op, inst, CACHE_CCR_CMD_MSK, timeout_us);
+}
+
+/* Issue the next page of a range, keeping what is left for later. */
+static void cache_op_next_page(struct ft9001_cache_op *op)
+{
+	uint32_t chunk = (op->left > CACHE_PAGE_MAX) ? CACHE_PAGE_MAX : op->left;
+
+	cache_page_issue(op->inst, op->next, chunk);
+	op->next += chunk;
+	op->left -= chunk;
+}
+
+int ft9001_cache_invalidate_range_start(struct ft9001_cache_op *op, CACHE_TypeDef *inst,
+					uint32_t addr, uint32_t size, uint32_t timeout_us)
+{
+	uint32_t base;
+	uint32_t len;
+
+	if (!cache_is_clocked(inst)) {
+		cache_op_skip(op, inst);
+		return 0;
+	}
+
+	if (!cache_idle(inst)) {
+		return -EBUSY;
+	}
+
+	base = addr & ~(CACHE_LINE_SIZE - 1U);
+	len = ((addr - base) + size + (CACHE_LINE_SIZE - 1U)) & ~(CACHE_LINE_SIZE - 1U);
+
+	if (!cache_is_enabled(inst) || len == 0U) {
+		cache_op_skip(op, inst);
+		return 0;
+	}
+
+	if (cache_inval_goes_global(inst, len)) {
+		return ft9001_cache_invalidate_all_start(op, inst, timeout_us);
+	}
+
+	op->inst = inst;
+	op->next = base;
+	op->left = len;
+	op->result = 0;
+	op->done = false;
+	ft9001_deadline_start(&op->dl, timeout_us);
+
+	cache_op_next_page(op);
+
+	return 0;
+}
+
+int ft9001_cache_op_poll(struct ft9001_cache_op *op)
+{
+	bool late;
+
+	if (op->done) {
+		return op->result;
+	}
+
+	/* Sample the deadline first, so an engine that finished in time is never
+	 * reported late.
+	 */
+	late = ft9001_deadline_expired(&op->dl);
+
+	if (!cache_idle(op->inst)) {
+		if (late) {
+			op->result = -ETIMEDOUT;
+			op->done = true;
+			return op->result;
+		}
+		return -EINPROGRESS;
+	}
+
+	if (op->left != 0U) {
+		if (late) {
+			op->result = -ETIMEDOUT;
+			op->done = true;
+			return op->result;
+		}
+		cache_op_next_page(op);
+		return -EINPROGRESS;
+	}
+
+	op->done = true;
+
+	return op->result;
+}
+
+int ft9001_cache_op_wait(struct ft9001_cache_op *op)
+{
+	int ret;
+
+	do {
+		ret = ft9001_cache_op_poll(op);
+	} while (ret == -EINPROGRESS);
+
+	return ret;
+}
+
+int ft9001_cache_op_barrier(struct ft9001_cache_op *op)
+{
+	int ret = ft9001_cache_op_wait(op);
+
+	__DSB();
+	__ISB();
+
+	return ret;
+}
+
+/* Read one word of a way, by cache address: word 0..3 of the data, or the tag
+ * when @p tag is set.
+ */
+static int cache_line_word_read(CACHE_TypeDef *inst, uint32_t way, uint32_t set, uint32_t word,
+				bool tag, uint32_t *val)
+{
+	uint32_t clcr = CACHE_CLCR_LCMD_VAL(CACHE_LCMD_SEARCH) |
+			CACHE_CLCR_CACHE_ADDRESS_VAL((set << 2) | word) | CACHE_CLCR_LGO;
+	int ret;
+
+	if (way != 0U) {
+		clcr |= CACHE_CLCR_WSEL;
+	}
+	if (tag) {
+		clcr |= CACHE_CLCR_TDSEL;
+	}
+
+	FT9001_WRITE_REG(inst->CACHE_CLCR, clcr);
+
+	ret = ft9001_tick_wait_bits(&inst->CACHE_CLCR, CACHE_CLCR_LGO, 0U, CACHE_CMD_TIMEOUT_US,
+				    NULL);
+	if (ret != 0) {
+		return ret;
+	}
+
+	*val = FT9001_READ_REG(inst->CACHE_CCVR);
+
+	return 0;
+}
+
+/* Line address from a tag word and the set it was read from. */
+static inline uint32_t cache_tag_addr(uint32_t tag, uint32_t set)
+{
+	return (tag & CACHE_CCVR_TAG_Msk) | (set * CACHE_LINE_SIZE);
+}
+
+int ft9001_cache_line_read(CACHE_TypeDef *inst, uint32_t way, uint32_t set,
+			   struct ft9001_cache_line *line)
+{
+	uint32_t tag;
+	int ret;
+
+	if (way >= FT9001_CACHE_WAY_COUNT || set >= FT9001_CACHE_SET_COUNT) {
+		return -EINVAL;
+	}
+
+	ret = cache_line_word_read(inst, way, set, 0U, true, &tag);
+	if (ret != 0) {
+		return ret;
+	}
+
+	line->addr = cache_tag_addr(tag, set);
+	line->valid = (tag & CACHE_CCVR_VALID) != 0U;
+	line->dirty = line->valid && (tag & CACHE_CCVR_MODIFIED) != 0U;
+
+	for (uint32_t w = 0U; w < FT9001_CACHE_LINE_SIZE / 4U; w++) {
+		ret = cache_line_word_read(inst, way, set, w, false, &line->data[w]);
+		if (ret != 0) {
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+int ft9001_cache_occupancy(CACHE_TypeDef *inst, struct ft9001_cache_window *windows,
+			   size_t count, uint32_t *valid_lines, uint32_t *dirty_lines)
+{
+	uint32_t valid = 0U;
+	uint32_t dirty = 0U;
+	int ret = 0;
+
+	for (size_t i = 0U; i < count; i++) {
+		windows[i].lines = 0U;
+		windows[i].dirty = 0U;
+	}
+
+	for (uint32_t way = 0U; way < FT9001_CACHE_WAY_COUNT && ret == 0; way++) {
+		for (uint32_t set = 0U; set < FT9001_CACHE_SET_COUNT; set++) {
+			uint32_t tag;
+			uint32_t addr;
+			bool modified;
+
+			ret = cache_line_word_read(inst, way, set, 0U, true, &tag);
+			if (ret != 0) {
+				break;
+			}
+			if ((tag & CACHE_CCVR_VALID) == 0U) {
+				continue;
+			}
+
+			addr = cache_tag_addr(tag, set);
+			modified = (tag & CACHE_CCVR_MODIFIED) != 0U;
+			valid++;
+			dirty += modified ? 1U : 0U;
+
+			for (size_t i = 0U; i < count; i++) {
+				if (addr - windows[i].base < windows[i].size) {
+					windows[i].lines++;
+					windows[i].dirty += modified ? 1U : 0U;
+				}
+			}
+		}
+	}
+
+	if (valid_lines != NULL) {
+		*valid_lines = valid;
+	}
+	if (dirty_lines != NULL) {
+		*dirty_lines = dirty;
+	}
+
+	return ret;
+}
+
+static int cache_invalidate_enable(CACHE_TypeDef *inst)
+{
+	int ret;
+
+	/* The engine needs its clock for the invalidate. */
+	FT9001_SET_BIT(inst->CACHE_CCG, CACHE_CCG_CLK_ENABLE);
+
+	ret = ft9001_cache_invalidate_all(inst);
+
+	if (ret != 0) {
+		return ret;
+	}
+
+	ft9001_cache_enable(inst);
+
+	return 0;
+}
+
+/* Push dirty lines out, if any region can hold them. */
+static int cache_clean_if_write_back(CACHE_TypeDef *inst)
+{
+	if (!cache_is_enabled(inst) || !cache_has_write_back(inst)) {
+		return 0;
+	}
+
+	return ft9001_cache_clean_all(inst);
+}
+
+int ft9001_cache_power_off(CACHE_TypeDef *inst)
+{
+	int ret = cache_clean_if_write_back(inst);
+
+	if (ret != 0) {
+		return ret;
+	}
+
+	ft9001_cache_disable(inst);
+	FT9001_CLEAR_BIT(inst->CACHE_CCG, CACHE_CCG_CLK_ENABLE);
+
+	return 0;
+}
+
+int ft9001_cache_power_on(CACHE_TypeDef *inst)
+{
+	return cache_invalidate_enable(inst);
+}
+
+int ft9001_cache_sleep_prepare(CACHE_TypeDef *inst, bool contents_lost)
+{
+	if (!contents_lost) {
+		return 0;
+	}
+
+	return cache_clean_if_write_back(inst);
+}
+
+int ft9001_cache_init(CACHE_TypeDef *inst, const struct ft9001_cache_config *cfg)
 {
 	ft9001_cache_disable(inst);
 	ft9001_cache_regions_configure(inst, cfg);
-	ft9001_cache_invalidate_all(inst);
-	ft9001_cache_enable(inst);
+
+	return cache_invalidate_enable(inst);
+}
+
+int ft9001_cache_init_regs(CACHE_TypeDef *inst, const struct ft9001_cache_regs *regs)
+{
+	ft9001_cache_disable(inst);
+	FT9001_WRITE_REG(inst->CACHE_CSACR, regs->csacr);
+	FT9001_MODIFY_REG(inst->CACHE_CACR, CACHE_CACR_ROM_CACHEABLE | CACHE_CACR_ROM_WT_WB,
+			  regs->cacr_rom & (CACHE_CACR_ROM_CACHEABLE | CACHE_CACR_ROM_WT_WB));
+
+	return cache_invalidate_enable(inst);
 }
@@ -0,0 +1,275 @@
+/*
+ * Copyright (c) 2026, FocalTech Systems CO.,Ltd
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "ft9001_cache_bench.h"
+#include "ft9001_irq.h"
+#include "ft9001_tick.h"
+
+/* Smallest window: one interpreter program and a few lookups. */
+#define BENCH_WINDOW_MIN (64U)
+
+/* SRAM side of the memcpy kernel. */
+#define BENCH_COPY_BUF (512U)
+
+/* Work per kernel run, sized to a few hundred microseconds uncached. */
+#define BENCH_INTERP_STEPS (4096U)
+#define BENCH_COPY_BYTES   (8192U)
+#define BENCH_LOOKUPS      (2048U)
+
+/* Longest line of the printed table. */
+#define BENCH_LINE_MAX (80U)
+
+static uint8_t s_bench_buf[BENCH_COPY_BUF];
+
+/* Results go here so the kernels cannot be optimised away. */
+static volatile uint32_t s_bench_sink;
+
+/* The kernels only read, so write-through stands for write-back as well. */
+static const enum ft9001_cache_mode s_bench_mode[FT9001_CACHE_BENCH_POLICY_COUNT] = {
+	[FT9001_CACHE_BENCH_OFF] = FT9001_CACHE_MODE_OFF,
+	[FT9001_CACHE_BENCH_CACHED] = FT9001_CACHE_MODE_WRITE_THROUGH,
+};
+
+static const char *const s_bench_kernel_name[FT9001_CACHE_BENCH_KERNEL_COUNT] = {
+	"interp",
+	"memcpy",
+	"lookup",
+};
+
+static const char *bench_region_name(enum ft9001_cache_region region)
+{
+	switch (region) {
+	case FT9001_CACHE_REGION_BOOT:
+		return "BOOT";
+	case FT9001_CACHE_REGION_ROM:
+		return "ROM";
+	case FT9001_CACHE_REGION_SPIM1:
+		return "SPIM1";
+	case FT9001_CACHE_REGION_SPIM2:
+		return "SPIM2";
+	case FT9001_CACHE_REGION_SPIM3:
+		return "SPIM3";
+	default:
+		return "?";
+	}
+}
+
+/* A small stack-less VM: every byte of the window is an opcode, the low three
+ * bits picking one of eight cases, with data-dependent jumps. Any content is a
+ * valid program and the step count bounds it.
+ */
+static uint32_t bench_interp(const uint8_t *code, uint32_t size)
+{
+	uint32_t acc = 1U;
+	uint32_t x = 0x9E3779B9UL;
+	uint32_t pc = 0U;
+
+	for (uint32_t step = 0U; step < BENCH_INTERP_STEPS; step++) {
+		uint8_t op = code[pc];
+
+		switch (op & 0x7U) {
+		case 0U:
+			acc += op;
+			break;
+		case 1U:
+			acc ^= x;
+			break;
+		case 2U:
+			x = (x << 5) | (x >> 27);
+			break;
+		case 3U:
+			acc -= x;
+			break;
+		case 4U:
+			if ((acc & 1U) != 0U) {
+				pc += op >> 3;
+			}
+			break;
+		case 5U:
+			x += acc;
+			break;
+		case 6U:
+			acc = (acc >> 1) | (acc << 31);
+			break;
+		default:
+			if ((x & 0x10U) != 0U) {
+				pc += (uint32_t)code[(pc + 1U) % size];
+			}
+			break;
+		}
+
+		pc = (pc + 1U) % size;
+	}
+
+	return acc ^ x;
+}
+
+static uint32_t bench_memcpy(const uint8_t *src, uint32_t size)
+{
+	uint32_t off = 0U;
+
+	for (uint32_t done = 0U; done < BENCH_COPY_BYTES; done += BENCH_COPY_BUF) {
+		uint32_t n = (size - off < BENCH_COPY_BUF) ? size - off : BENCH_COPY_BUF;
+
+		memcpy(s_bench_buf, &src[off], n);
+		off = (off + n) % size;
+	}
+
+	return s_bench_buf[0];
+}
+
+static uint32_t bench_lookup(const uint8_t *table, uint32_t size)
+{
+	const volatile uint32_t *words = (const volatile uint32_t *)table;
+	uint32_t count = size / sizeof(uint32_t);
+	uint32_t idx = 12345U;
+	uint32_t sum = 0U;
+
+	for (uint32_t i = 0U; i < BENCH_LOOKUPS; i++) {
+		idx = (idx * 1103515245UL) + 12345UL;
+		sum += words[(idx >> 8) % count];
+	}
+
+	return sum;
+}
+
+static uint32_t bench_kernel_run(enum ft9001_cache_bench_kernel kernel, const uint8_t *win,
+				 uint32_t size)
+{
+	switch (kernel) {
+	case FT9001_CACHE_BENCH_INTERP:
+		return bench_interp(win, size);
+	case FT9001_CACHE_BENCH_MEMCPY:
+		return bench_memcpy(win, size);
+	case FT9001_CACHE_BENCH_LOOKUP:
+	default:
+		return bench_lookup(win, size);
+	}
+}
+
+/* Best of @p reps masked runs, after one untimed run to warm the caches. */
+static int bench_measure(const struct ft9001_cache_bench_target *t,
+			 enum ft9001_cache_bench_kernel kernel, uint32_t reps, uint32_t *ticks)
+{
+	const uint8_t *win = (const uint8_t *)t->addr;
+	uint32_t best = UINT32_MAX;
+	int ret = ft9001_cache_clean_invalidate_all(DCACHE);
+
+	if (ret != 0) {
+		return ret;
+	}
+
+	s_bench_sink = bench_kernel_run(kernel, win, t->size);
+
+	for (uint32_t i = 0U; i < reps; i++) {
+		uint32_t key = ft9001_irq_lock();
+		uint32_t start = ft9001_tick_get();
+		uint32_t spent;
+
+		s_bench_sink = bench_kernel_run(kernel, win, t->size);
+		spent = ft9001_tick_get() - start;
+
+		ft9001_irq_unlock(key);
+
+		if (spent < best) {
+			best = spent;
+		}
+	}
+
+	*ticks = best;
+
+	return 0;
+}
+
+static int bench_target_run(struct ft9001_cache_bench_target *t, uint32_t reps)
+{
+	int ret;
+
+	for (uint32_t p = 0U; p < (uint32_t)FT9001_CACHE_BENCH_POLICY_COUNT; p++) {
+		ft9001_cache_region_mode_set(DCACHE, t->region, s_bench_mode[p]);
+
+		for (uint32_t k = 0U; k < (uint32_t)FT9001_CACHE_BENCH_KERNEL_COUNT; k++) {
+			ret = bench_measure(t, (enum ft9001_cache_bench_kernel)k, reps,
+					    &t->ticks[p][k]);
+			if (ret != 0) {
+				return ret;
+			}
+		}
+	}
+
+	return 0;
+}
+
+int ft9001_cache_bench_run(struct ft9001_cache_bench_target *targets, size_t count,
+			   uint32_t reps)
+{
+	struct ft9001_cache_regs saved;
+	int ret = 0;
+	int flush;
+
+	if (reps == 0U) {
+		return -EINVAL;
+	}
+
+	for (size_t i = 0U; i < count; i++) {
+		if ((uint32_t)targets[i].region > (uint32_t)FT9001_CACHE_REGION_SPIM3 ||
+		    targets[i].size < BENCH_WINDOW_MIN) {
+			return -EINVAL;
+		}
+	}
+
+	saved.csacr = FT9001_READ_REG(DCACHE->CACHE_CSACR);
+	saved.cacr_rom = FT9001_READ_REG(DCACHE->CACHE_CACR) &
+			 (CACHE_CACR_ROM_CACHEABLE | CACHE_CACR_ROM_WT_WB);
+
+	for (size_t i = 0U; i < count && ret == 0; i++) {
+		ret = bench_target_run(&targets[i], reps);
+	}
+
+	FT9001_WRITE_REG(DCACHE->CACHE_CSACR, saved.csacr);
+	FT9001_MODIFY_REG(DCACHE->CACHE_CACR, CACHE_CACR_ROM_CACHEABLE | CACHE_CACR_ROM_WT_WB,
+			  saved.cacr_rom);
+
+	/* Nothing cached under a benchmark policy outlives it. */
+	flush = ft9001_cache_clean_invalidate_all(DCACHE);
+
+	return (ret != 0) ? ret : flush;
+}
+
+/* Speed-up over the uncached run, in hundredths. */
+static uint32_t bench_speedup(uint32_t off_ticks, uint32_t ticks)
+{
+	return (ticks != 0U) ? (uint32_t)(((uint64_t)off_ticks * 100U) / ticks) : 0U;
+}
+
+void ft9001_cache_bench_print(const struct ft9001_cache_bench_target *targets, size_t count,
+			      ft9001_cache_bench_print_t print, void *user_data)
+{
+	char line[BENCH_LINE_MAX];
+
+	print("region kernel     off_us   on_us  on_x", user_data);
+
+	for (size_t i = 0U; i < count; i++) {
+		const struct ft9001_cache_bench_target *t = &targets[i];
+
+		for (uint32_t k = 0U; k < (uint32_t)FT9001_CACHE_BENCH_KERNEL_COUNT; k++) {
+			uint32_t off = t->ticks[FT9001_CACHE_BENCH_OFF][k];
+			uint32_t on = t->ticks[FT9001_CACHE_BENCH_CACHED][k];
+			uint32_t on_x = bench_speedup(off, on);
+
+			(void)snprintf(line, sizeof(line), "%-6s %-6s %9lu %7lu %2lu.%02lu",
+				       bench_region_name(t->region), s_bench_kernel_name[k],
+				       (unsigned long)(off / FT9001_TICK_PER_US),
+				       (unsigned long)(on / FT9001_TICK_PER_US),
+				       (unsigned long)(on_x / 100U), (unsigned long)(on_x % 100U));
+			print(line, user_data);
+		}
+	}
+}
@@ -5,9 +5,19 @@
  */
 
 #include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
 
 #include "ft9001.h"
 #include "ft9001_cpm.h"
+#include "ft9001_cpm_priv.h"
+#include "ft9001_irq.h"
+#include "ft9001_tc.h"
+#include "ft9001_tick.h"
+
+#ifdef CONFIG_USE_FT9001_SYSTEM_INIT
+#include "system_ft9001.h"
+#endif
 
 /* OTP constants */
 #define OTP_VALID_SIGNATURE (0x55AA55AAUL)
@@ -28,34 +38,127 @@
 #define OTP_BASE_TRIM_VALUE (0x08200700UL) /* partX value    */
 #define OTP_BASE_TRIM_EN (0x08200704UL)	   /* partX enable   */
 #define OTP_PART_STRIDE (0x60UL)
+#define OTP_PART_COUNT (3UL)
 
 /* 400M trim */
 #define OTP_OSC400_TRIM_ADDR (0x082000E4UL)
 
-/* Budget for the OSC8M switch that precedes a trim write. Generous because the
- * routine may run from the high-speed oscillator, where each poll is cheap.
+/* Timeout for the OSC8M switch that precedes a trim write. OSC8M is normally
+ * running already, so this only covers the mux handshake.
+ */
+#define CPM_TRIM_SWITCH_TIMEOUT_US (1000U)
+
+#define CPM_OSC8M_HZ   (8000000UL)
+#define CPM_PMU128K_HZ (128000UL)
+#define CPM_RTC32K_HZ  (32768UL)
+
+/* Timeout for the calibration reference crystal to start. The wait for its
+ * starting edge is bounded by two reference periods instead.
+ */
+#define CPM_CAL_REF_STABLE_TIMEOUT_US (2000000U)
+
+/* Nominal HSOSC frequency per trim, indexed by enum ft9001_cpm_osc_freq */
+static const uint32_t s_hsosc_trim_hz[FT9001_CPM_OSC_FREQ_COUNT] = {
+	[FT9001_CPM_OSC_FREQ_320MHZ] = 320000000UL,
+	[FT9001_CPM_OSC_FREQ_400MHZ] = 400000000UL,
+};
+
+/* Stable-time register and OCSR enable and STABLE bits, indexed by
+ * enum ft9001_cpm_osc
+ */
+static const struct ft9001_cpm_osc_desc s_osc_desc[FT9001_CPM_OSC_COUNT] = {
+	[FT9001_CPM_OSC_PMU128K] = {&CPM->OSCLSTIMER, CPM_OCSR_PMU128K_EN,
+				    CPM_OCSR_PMU128K_STABLE},
+	[FT9001_CPM_OSC_HSOSC] = {&CPM->OSCHSTIMER, CPM_OCSR_OSC400M_EN, CPM_OCSR_OSC400M_STABLE},
+	[FT9001_CPM_OSC_OSCEXT] = {&CPM->OSCESTIMER, CPM_OCSR_OSCEXT_EN, CPM_OCSR_OSCEXT_STABLE},
+	[FT9001_CPM_OSC_RTC32K] = {&CPM->RTCSTIMER, CPM_OCSR_RTC32K_EN, CPM_OCSR_RTC32K_STABLE},
+};
+
+/* Divider enables driven by a clock plan; CLKOUT is left alone. */
+#define CPM_PLAN_DIVEN                                                                     \
+	(CPM_CDIVENR_IPS_DIVEN | CPM_CDIVENR_AHB3_DIVEN | CPM_CDIVENR_ARITH_DIVEN |        \
+	 CPM_CDIVENR_MCC_DIVEN | CPM_CDIVENR_ADC_DIVEN | CPM_CDIVENR_MESH_DIVEN |          \
+	 CPM_CDIVENR_TC_DIVEN | CPM_CDIVENR_TRACE_DIVEN | CPM_CDIVENR_I2S_M_DIVEN |        \
+	 CPM_CDIVENR_I2S_S_DIVEN)
+
+/* Divider fields driven by a clock plan, per register. */
+#define CPM_PLAN_SCDIVR_MSK (CPM_SCDIVR_SYS_DIV_Msk | CPM_SCDIVR_TRACE_DIV_Msk)
+#define CPM_PLAN_PCDIVR1_MSK                                                               \
+	(CPM_PCDIVR1_AHB3_DIV_Msk | CPM_PCDIVR1_ARITH_DIV_Msk | CPM_PCDIVR1_IPS_DIV_Msk)
+#define CPM_PLAN_PCDIVR2_MSK                                                               \
+	(CPM_PCDIVR2_TC_DIV_Msk | CPM_PCDIVR2_MESH_DIV_Msk | CPM_PCDIVR2_ADC_DIV_Msk |     \
+	 CPM_PCDIVR2_MCC_DIV_Msk)
+#define CPM_PLAN_PCDIVR4_MSK (CPM_PCDIVR4_I2S_S_DIV_Msk | CPM_PCDIVR4_I2S_M_DIV_Msk)
+
+/* OTP trim words, read once. Every partition is kept so the choice can be
+ * inspected later; trim loads only use the selected one.
  */
-#define CPM_TRIM_SWITCH_POLLS (2000000UL)
+struct cpm_otp_part {
+	bool valid;
+	bool has_320;
+	uint32_t trim_320;
+};
+
+static struct {
+	bool parsed;
+	uint32_t sel;
+	struct cpm_otp_part part[OTP_PART_COUNT];
+	bool has_400;
+	uint32_t trim_400;
+} s_otp;
 
 /* Track last HSOSC nominal freq when SYSCLK = OSC400M */
 static uint32_t s_hsosc_nominal_hz = 320000000UL;
 
-static int cpm_wait_bits_set(volatile uint32_t *reg, uint32_t mask, uint32_t poll_budget)
+/* Calibrated HSOSC frequency, 0 until measured for the current trim */
+static uint32_t s_hsosc_measured_hz;
+
+/* Trim loaded by the last successful ft9001_cpm_hsosc_trim_set() */
+static enum ft9001_cpm_osc_freq s_hsosc_trim;
+static bool s_hsosc_trim_loaded;
+
+/* Clock-tree model, indexed by enum ft9001_cpm_clk. Built lazily on first read
+ * and rebuilt by every setter, so the getters never touch the bus.
+ */
+static uint32_t s_clk_hz[FT9001_CPM_CLK_COUNT];
+static bool s_clk_tree_valid;
+static struct ft9001_cpm_clk_listener *s_clk_listeners;
+
+/* Timing of the last system clock switch */
+static struct ft9001_cpm_switch_time s_switch_time;
+
+/* Set while a multi-step reconfiguration owns the CPM, see ft9001_cpm_claim(). */
+static bool s_cpm_claimed;
+
+int ft9001_cpm_claim(void)
 {
-	if (poll_budget == FT9001_CPM_POLL_FOREVER) {
-		while (((*reg) & mask) != mask) {
-		}
-		return 0;
-	}
+	uint32_t key = ft9001_irq_lock();
+	int ret = 0;
 
-	while (poll_budget != 0U) {
-		if (((*reg) & mask) == mask) {
-			return 0;
-		}
-		poll_budget--;
+	if (s_cpm_claimed) {
+		ret = -EBUSY;
+	} else {
+		s_cpm_claimed = true;
 	}
 
-	return -ETIMEDOUT;
+	ft9001_irq_unlock(key);
+
+	return ret;
+}
+
+void ft9001_cpm_release(void)
+{
+	uint32_t key = ft9001_irq_lock();
+
+	s_cpm_claimed = false;
+
+	ft9001_irq_unlock(key);
+}
+
+static int cpm_wait_bits_set(volatile uint32_t *reg, uint32_t mask, uint32_t timeout_us,
+			     uint32_t *waited_us)
+{
+	return ft9001_tick_wait_bits(reg, mask, mask, timeout_us, waited_us);
 }
 
 /* VCCCTMR: lock/undo override window used for protected trim registers */
@@ -76,19 +179,355 @@ static inline void cpm_unlock_override(uint32_t override_bits)
 	FT9001_WRITE_REG(CPM->VCCCTMR, base | CPM_VCCCTMR_CORE_TEST_KEY_11 | override_bits);
 }
 
-/* Choose OTP part: prefer part2, then part1, then part0; default to part2. */
-static inline uint32_t cpm_pick_otp_part(void)
+static inline uint32_t cpm_otp_read(uint32_t addr)
+{
+	return *(volatile uint32_t *)addr;
+}
+
+/* Read every trim word out of OTP into s_otp. The only routine that touches
+ * OTP; choose the partition as before: prefer part2, then part1, then part0,
+ * default to part2.
+ */
+static void cpm_otp_parse(void)
+{
+	static const uint32_t valid_addr[OTP_PART_COUNT] = {
+		OTP_PART0_VALID_ADDR,
+		OTP_PART1_VALID_ADDR,
+		OTP_PART2_VALID_ADDR,
+	};
+	uint32_t v;
+
+	s_otp.sel = 2UL;
+
+	for (uint32_t part = 0U; part < OTP_PART_COUNT; part++) {
+		struct cpm_otp_part *p = &s_otp.part[part];
+		uint32_t off = part * OTP_PART_STRIDE;
+
+		p->valid = cpm_otp_read(valid_addr[part]) == OTP_VALID_SIGNATURE;
+		p->has_320 = cpm_otp_read(OTP_BASE_TRIM_EN + off) == OTP_OSC320_TRIM_KEY;
+		p->trim_320 = cpm_otp_read(OTP_BASE_TRIM_VALUE + off);
+	}
+
+	for (uint32_t part = OTP_PART_COUNT; part > 0U; part--) {
+		if (s_otp.part[part - 1U].valid) {
+			s_otp.sel = part - 1U;
+			break;
+		}
+	}
+
+	v = cpm_otp_read(OTP_OSC400_TRIM_ADDR);
+	s_otp.has_400 = (v & OTP_OSC_VALID_MASK) == OTP_OSC_VALID_TAG;
+	s_otp.trim_400 = v;
+
+	s_otp.parsed = true;
+}
+
+/* Look a trim up in the RAM table, parsing OTP on first use. */
+static int cpm_otp_trim_find(enum ft9001_cpm_osc_freq freq, uint32_t *trim)
+{
+	const struct cpm_otp_part *p;
+
+	if (!s_otp.parsed) {
+		cpm_otp_parse();
+	}
+
+	p = &s_otp.part[s_otp.sel];
+
+	switch (freq) {
+	case FT9001_CPM_OSC_FREQ_320MHZ:
+		*trim = p->trim_320;
+		return p->has_320 ? 0 : -ENOENT;
+	case FT9001_CPM_OSC_FREQ_400MHZ:
+		*trim = s_otp.trim_400;
+		return s_otp.has_400 ? 0 : -ENOENT;
+	default:
+		return -EINVAL;
+	}
+}
+
+/* Divide by (field + 1) when the divider is enabled, pass through otherwise.
+ * A null enable mask means the divider has no enable bit and always applies.
+ */
+static inline uint32_t cpm_div_apply(uint32_t hz, uint32_t reg, uint32_t msk, uint32_t pos,
+				     uint32_t diven)
+{
+	if (diven != 0U && !FT9001_READ_BIT(CPM->CDIVENR, diven)) {
+		return hz;
+	}
+
+	return hz / (((reg & msk) >> pos) + 1UL);
+}
+
+static uint32_t cpm_oscl_hz(uint32_t cswcfgr)
 {
-	if (*(volatile uint32_t *)OTP_PART2_VALID_ADDR == OTP_VALID_SIGNATURE) {
-		return 2UL;
+	switch (cswcfgr & CPM_CSWCFGR_OSCL_SEL_ST_Msk) {
+	case CPM_CSWCFGR_OSCL_SEL_ST_PMU128K:
+		return CPM_PMU128K_HZ;
+	case CPM_CSWCFGR_OSCL_SEL_ST_RTC32K:
+		return CPM_RTC32K_HZ;
+	default:
+		return 0U;
 	}
-	if (*(volatile uint32_t *)OTP_PART1_VALID_ADDR == OTP_VALID_SIGNATURE) {
-		return 1UL;
+}
+
+static inline uint32_t cpm_field_get(uint32_t reg, uint32_t msk, uint32_t pos, uint32_t diven,
+				     uint32_t cdivenr)
+{
+	if (diven != 0U && (cdivenr & diven) == 0U) {
+		return 0U;
 	}
-	if (*(volatile uint32_t *)OTP_PART0_VALID_ADDR == OTP_VALID_SIGNATURE) {
-		return 0UL;
+
+	return (reg & msk) >> pos;
+}
+
+static uint32_t cpm_sys_base_hz(uint32_t cswcfgr)
+{
+	return ((cswcfgr & CPM_CSWCFGR_SYS_SEL_Msk) == CPM_CSWCFGR_SYS_SEL_OSC8M)
+		       ? CPM_OSC8M_HZ
+		       : ft9001_cpm_hsosc_freq_hz_get();
+}
+
+/* Every domain but CLKOUT, from a plan and a source frequency. */
+static void cpm_clk_plan_hz(const struct ft9001_cpm_clk_plan *p, uint32_t src_hz,
+			    uint32_t hz[FT9001_CPM_CLK_COUNT])
+{
+	uint32_t sys;
+	uint32_t ips;
+
+	sys = src_hz / (p->sys_div + 1UL);
+	ips = sys / (p->ips_div + 1UL);
+
+	hz[FT9001_CPM_CLK_SYS] = sys;
+	hz[FT9001_CPM_CLK_AHB3] = sys / (p->ahb3_div + 1UL);
+	hz[FT9001_CPM_CLK_ARITH] = sys / (p->arith_div + 1UL);
+	hz[FT9001_CPM_CLK_IPS] = ips;
+	hz[FT9001_CPM_CLK_TC] = ips / (p->tc_div + 1UL);
+	hz[FT9001_CPM_CLK_ADC] = ips / (p->adc_div + 1UL);
+	hz[FT9001_CPM_CLK_TRACE] = sys / (p->trace_div + 1UL);
+	hz[FT9001_CPM_CLK_MCC] = ips / (p->mcc_div + 1UL);
+	hz[FT9001_CPM_CLK_MESH] = ips / (p->mesh_div + 1UL);
+	hz[FT9001_CPM_CLK_I2S_M] = sys / (p->i2s_m_div + 1UL);
+	hz[FT9001_CPM_CLK_I2S_S] = sys / (p->i2s_s_div + 1UL);
+}
+
+static uint32_t cpm_clkout_hz(uint32_t cswcfgr, const uint32_t hz[FT9001_CPM_CLK_COUNT])
+{
+	uint32_t base_hz;
+
+	switch (cswcfgr & CPM_CSWCFGR_CLKOUT_SEL_Msk) {
+	case CPM_CSWCFGR_CLKOUT_SEL_SYS:
+		base_hz = hz[FT9001_CPM_CLK_SYS];
+		break;
+	case CPM_CSWCFGR_CLKOUT_SEL_ARITH:
+		base_hz = hz[FT9001_CPM_CLK_ARITH];
+		break;
+	case CPM_CSWCFGR_CLKOUT_SEL_OSCL:
+		base_hz = cpm_oscl_hz(cswcfgr);
+		break;
+	default:
+		/* The NFC PLL is not modelled. */
+		base_hz = 0U;
+		break;
 	}
-	return 2UL;
+
+	return cpm_div_apply(base_hz, FT9001_READ_REG(CPM->SCDIVR), CPM_SCDIVR_CLKOUT_DIV_Msk,
+			     CPM_SCDIVR_CLKOUT_DIV_Pos, CPM_CDIVENR_CLKOUT_DIVEN);
+}
+
+static void cpm_clk_tree_compute(uint32_t hz[FT9001_CPM_CLK_COUNT])
+{
+	uint32_t cswcfgr = FT9001_READ_REG(CPM->CSWCFGR);
+	struct ft9001_cpm_clk_plan plan;
+
+	ft9001_cpm_clk_plan_get(&plan);
+	cpm_clk_plan_hz(&plan, cpm_sys_base_hz(cswcfgr), hz);
+	hz[FT9001_CPM_CLK_CLKOUT] = cpm_clkout_hz(cswcfgr, hz);
+}
+
+/* Keep the CMSIS core clock in step with the model, so SysTick setups and
+ * delay loops built on it follow every change.
+ */
+static inline void cpm_core_clock_sync(uint32_t sys_hz)
+{
+#ifdef CONFIG_USE_FT9001_SYSTEM_INIT
+	SystemCoreClock = sys_hz;
+#else
+	(void)sys_hz;
+#endif
+}
+
+/* Rebuild the model and tell listeners what moved. Called by every setter once
+ * the hardware has settled, successful or not.
+ */
+static void cpm_clk_tree_update(void)
+{
+	uint32_t hz[FT9001_CPM_CLK_COUNT];
+	uint32_t changed = 0U;
+	struct ft9001_cpm_clk_listener *l;
+	uint32_t key;
+
+	cpm_clk_tree_compute(hz);
+
+	/* Swap the model in whole, so a reader in an ISR never mixes domains
+	 * from before and after the change.
+	 */
+	key = ft9001_irq_lock();
+	for (uint32_t i = 0U; i < (uint32_t)FT9001_CPM_CLK_COUNT; i++) {
+		if (!s_clk_tree_valid || hz[i] != s_clk_hz[i]) {
+			changed |= FT9001_CPM_CLK_BIT(i);
+		}
+		s_clk_hz[i] = hz[i];
+	}
+	s_clk_tree_valid = true;
+	cpm_core_clock_sync(hz[FT9001_CPM_CLK_SYS]);
+	ft9001_irq_unlock(key);
+
+	if (changed == 0U) {
+		return;
+	}
+
+	for (l = s_clk_listeners; l != NULL; l = l->next) {
+		if (l->cb != NULL && (l->mask & changed) != 0U) {
+			l->cb(l->mask & changed, l->user_data);
+		}
+	}
+}
+
+/* Tell pre-change listeners what is about to move. Called by the setters with
+ * the model they expect, right before the register write that changes it.
+ */
+static void cpm_clk_pre_notify(const uint32_t next[FT9001_CPM_CLK_COUNT])
+{
+	uint32_t changing = 0U;
+	struct ft9001_cpm_clk_listener *l;
+
+	for (uint32_t i = 0U; i < (uint32_t)FT9001_CPM_CLK_COUNT; i++) {
+		if (next[i] != ft9001_cpm_clk_freq_hz_get((enum ft9001_cpm_clk)i)) {
+			changing |= FT9001_CPM_CLK_BIT(i);
+		}
+	}
+
+	if (changing == 0U) {
+		return;
+	}
+
+	for (l = s_clk_listeners; l != NULL; l = l->next) {
+		if (l->pre_cb != NULL && (l->mask & changing) != 0U) {
+			l->pre_cb(l->mask & changing, next, l->user_data);
+		}
+	}
+}
+
+/* Model after a divider plan or source change, at the model's view of the
+ * source frequency (calibrated if measured).
+ */
+static void cpm_clk_plan_predict(const struct ft9001_cpm_clk_plan *plan, uint32_t src_hz,
+				 uint32_t next[FT9001_CPM_CLK_COUNT])
+{
+	(void)ft9001_cpm_clk_plan_check(plan, src_hz, next);
+}
+
+uint32_t ft9001_cpm_clk_freq_hz_get(enum ft9001_cpm_clk clk)
+{
+	uint32_t hz[FT9001_CPM_CLK_COUNT];
+	uint32_t key;
+
+	if ((uint32_t)clk >= (uint32_t)FT9001_CPM_CLK_COUNT) {
+		return 0U;
+	}
+
+	if (!s_clk_tree_valid) {
+		cpm_clk_tree_compute(hz);
+
+		/* Another context may have built it in the meantime. */
+		key = ft9001_irq_lock();
+		if (!s_clk_tree_valid) {
+			for (uint32_t i = 0U; i < (uint32_t)FT9001_CPM_CLK_COUNT; i++) {
+				s_clk_hz[i] = hz[i];
+			}
+			s_clk_tree_valid = true;
+			cpm_core_clock_sync(hz[FT9001_CPM_CLK_SYS]);
+		}
+		ft9001_irq_unlock(key);
+	}
+
+	return s_clk_hz[clk];
+}
+
+void ft9001_cpm_clk_tree_refresh(void)
+{
+	cpm_clk_tree_update();
+}
+
+int ft9001_cpm_clk_listener_register(struct ft9001_cpm_clk_listener *listener)
+{
+	struct ft9001_cpm_clk_listener **pp;
+	uint32_t key;
+	int ret = 0;
+
+	if (listener->cb == NULL && listener->pre_cb == NULL) {
+		return -EINVAL;
+	}
+
+	key = ft9001_irq_lock();
+
+	for (pp = &s_clk_listeners; *pp != NULL; pp = &(*pp)->next) {
+		if (*pp == listener) {
+			ret = -EALREADY;
+			break;
+		}
+	}
+
+	if (ret == 0) {
+		listener->next = NULL;
+		*pp = listener;
+	}
+
+	ft9001_irq_unlock(key);
+
+	return ret;
+}
+
+int ft9001_cpm_clk_listener_unregister(struct ft9001_cpm_clk_listener *listener)
+{
+	struct ft9001_cpm_clk_listener **pp;
+	uint32_t key;
+	int ret = -ENOENT;
+
+	key = ft9001_irq_lock();
+
+	/* listener->next is left as is, so a notification walking the list
+	 * from another context still reaches the listeners after it.
+	 */
+	for (pp = &s_clk_listeners; *pp != NULL; pp = &(*pp)->next) {
+		if (*pp == listener) {
+			*pp = listener->next;
+			ret = 0;
+			break;
+		}
+	}
+
+	ft9001_irq_unlock(key);
+
+	return ret;
+}
+
+bool ft9001_cpm_clk_listener_is_registered(const struct ft9001_cpm_clk_listener *listener)
+{
+	const struct ft9001_cpm_clk_listener *l;
+	bool found = false;
+	uint32_t key = ft9001_irq_lock();
+
+	for (l = s_clk_listeners; l != NULL; l = l->next) {
+		if (l == listener) {
+			found = true;
+			break;
+		}
+	}
+
+	ft9001_irq_unlock(key);
+
+	return found;
 }
 
 enum ft9001_cpm_sysclk_source ft9001_cpm_sysclk_source_get(void)
@@ -99,127 +538,813 @@ enum ft9001_cpm_sysclk_source ft9001_cpm_sysclk_source_get(void)
 	return (v & 0x1UL) ? FT9001_CPM_SYSCLK_OSC400M : FT9001_CPM_SYSCLK_OSC8M;
 }
 
-int ft9001_cpm_sysclk_source_set(enum ft9001_cpm_sysclk_source source, uint32_t poll_budget)
+static int cpm_sysclk_bits(enum ft9001_cpm_sysclk_source source, uint32_t *en, uint32_t *stable,
+			   uint32_t *sel, uint32_t *sel_st)
 {
-	int ret;
-
 	switch (source) {
 	case FT9001_CPM_SYSCLK_OSC8M:
-		FT9001_SET_BIT(CPM->OCSR, CPM_OCSR_OSC8M_EN);
-		ret = cpm_wait_bits_set(&CPM->OCSR, CPM_OCSR_OSC8M_STABLE, poll_budget);
+		*en = CPM_OCSR_OSC8M_EN;
+		*stable = CPM_OCSR_OSC8M_STABLE;
+		*sel = CPM_CSWCFGR_SYS_SEL_OSC8M;
+		*sel_st = CPM_CSWCFGR_SYS_SEL_ST_OSC8M;
+		return 0;
+	case FT9001_CPM_SYSCLK_OSC400M:
+		*en = CPM_OCSR_OSC400M_EN;
+		*stable = CPM_OCSR_OSC400M_STABLE;
+		*sel = CPM_CSWCFGR_SYS_SEL_OSC400M;
+		*sel_st = CPM_CSWCFGR_SYS_SEL_ST_OSC400M;
+		return 0;
+	default:
+		return -EINVAL;
+	}
+}
+
+/* Finish a switch: wait out the source's stable flag if still pending, then
+ * commit SYS_SEL, all against the deadline taken at start. Time spent in the
+ * pre-change listeners is not charged to that deadline.
+ */
+static int cpm_sysclk_switch_commit(struct ft9001_cpm_switch *sw)
+{
+	struct ft9001_cpm_clk_plan plan;
+	uint32_t next[FT9001_CPM_CLK_COUNT];
+	uint32_t left_us;
+	uint32_t src_hz;
+	uint32_t en;
+	uint32_t stable;
+	uint32_t sel;
+	uint32_t sel_st;
+	int ret;
+
+	(void)cpm_sysclk_bits(sw->source, &en, &stable, &sel, &sel_st);
+
+	if (sw->state == FT9001_CPM_SWITCH_STABILISING) {
+		ret = cpm_wait_bits_set(&CPM->OCSR, stable, ft9001_deadline_left_us(&sw->dl), NULL);
+		s_switch_time.stable_us = ft9001_deadline_elapsed_us(&sw->dl);
 		if (ret != 0) {
 			return ret;
 		}
+	}
 
-		FT9001_MODIFY_REG(CPM->CSWCFGR, CPM_CSWCFGR_SYS_SEL_Msk,
-				  CPM_CSWCFGR_SYS_SEL_OSC8M);
-		return cpm_wait_bits_set(&CPM->CSWCFGR, CPM_CSWCFGR_SYS_SEL_ST_OSC8M, poll_budget);
+	ft9001_cpm_clk_plan_get(&plan);
+	src_hz = (sw->source == FT9001_CPM_SYSCLK_OSC8M) ? CPM_OSC8M_HZ
+							 : ft9001_cpm_hsosc_freq_hz_get();
+	cpm_clk_plan_predict(&plan, src_hz, next);
 
-	case FT9001_CPM_SYSCLK_OSC400M:
-		FT9001_SET_BIT(CPM->OCSR, CPM_OCSR_OSC400M_EN);
-		ret = cpm_wait_bits_set(&CPM->OCSR, CPM_OCSR_OSC400M_STABLE, poll_budget);
-		if (ret != 0) {
-			return ret;
+	/* A listener draining a UART may take longer than the select itself. */
+	left_us = ft9001_deadline_left_us(&sw->dl);
+	cpm_clk_pre_notify(next);
+
+	ft9001_irq_reg_modify(&CPM->CSWCFGR, CPM_CSWCFGR_SYS_SEL_Msk, sel);
+	return cpm_wait_bits_set(&CPM->CSWCFGR, sel_st, left_us, &s_switch_time.select_us);
+}
+
+static void cpm_sysclk_switch_finish(struct ft9001_cpm_switch *sw, int result)
+{
+	sw->state = FT9001_CPM_SWITCH_DONE;
+	sw->result = result;
+
+	cpm_clk_tree_update();
+}
+
+/* End a switch started through the public API: give the CPM back before the
+ * callback, so the callback may start the next change.
+ */
+static int cpm_sysclk_switch_end(struct ft9001_cpm_switch *sw, int result)
+{
+	cpm_sysclk_switch_finish(sw, result);
+	ft9001_cpm_release();
+
+	if (sw->cb != NULL) {
+		sw->cb(result, sw->user_data);
+	}
+
+	return result;
+}
+
+/* Start a switch under a claim the caller already holds. */
+static int cpm_sysclk_switch_begin(struct ft9001_cpm_switch *sw,
+				   enum ft9001_cpm_sysclk_source source, uint32_t timeout_us)
+{
+	uint32_t en;
+	uint32_t stable;
+	uint32_t sel;
+	uint32_t sel_st;
+	uint32_t key;
+	int ret = cpm_sysclk_bits(source, &en, &stable, &sel, &sel_st);
+
+	if (ret != 0) {
+		return ret;
+	}
+
+	sw->source = source;
+	sw->state = FT9001_CPM_SWITCH_STABILISING;
+	sw->result = -EINPROGRESS;
+
+	key = ft9001_irq_lock();
+	s_switch_time.stable_us = 0U;
+	s_switch_time.select_us = 0U;
+	ft9001_irq_unlock(key);
+
+	ft9001_deadline_start(&sw->dl, timeout_us);
+	ft9001_irq_reg_set(&CPM->OCSR, en);
+
+	return 0;
+}
+
+/* Start, commit and finish a switch under a claim the caller already holds. */
+static int cpm_sysclk_switch_run(enum ft9001_cpm_sysclk_source source, uint32_t timeout_us)
+{
+	struct ft9001_cpm_switch sw = {0};
+	int ret = cpm_sysclk_switch_begin(&sw, source, timeout_us);
+
+	if (ret != 0) {
+		return ret;
+	}
+
+	ret = cpm_sysclk_switch_commit(&sw);
+	cpm_sysclk_switch_finish(&sw, ret);
+
+	return ret;
+}
+
+int ft9001_cpm_sysclk_switch_start(struct ft9001_cpm_switch *sw,
+				   enum ft9001_cpm_sysclk_source source, uint32_t timeout_us)
+{
+	int ret = ft9001_cpm_claim();
+
+	if (ret != 0) {
+		return ret;
+	}
+
+	ret = cpm_sysclk_switch_begin(sw, source, timeout_us);
+	if (ret != 0) {
+		ft9001_cpm_release();
+	}
+
+	return ret;
+}
+
+int ft9001_cpm_sysclk_switch_poll(struct ft9001_cpm_switch *sw)
+{
+	uint32_t en;
+	uint32_t stable;
+	uint32_t sel;
+	uint32_t sel_st;
+	bool late;
+
+	if (sw->state != FT9001_CPM_SWITCH_STABILISING) {
+		return (sw->state == FT9001_CPM_SWITCH_READY) ? 0 : sw->result;
+	}
+
+	(void)cpm_sysclk_bits(sw->source, &en, &stable, &sel, &sel_st);
+
+	late = ft9001_deadline_expired(&sw->dl);
+	if (!FT9001_READ_BIT(CPM->OCSR, stable)) {
+		if (!late) {
+			return -EINPROGRESS;
 		}
 
-		FT9001_MODIFY_REG(CPM->CSWCFGR, CPM_CSWCFGR_SYS_SEL_Msk,
-				  CPM_CSWCFGR_SYS_SEL_OSC400M);
-		return cpm_wait_bits_set(&CPM->CSWCFGR, CPM_CSWCFGR_SYS_SEL_ST_OSC400M,
-					 poll_budget);
+		s_switch_time.stable_us = ft9001_deadline_elapsed_us(&sw->dl);
+		return cpm_sysclk_switch_end(sw, -ETIMEDOUT);
+	}
 
-	default:
-		return -EINVAL;
+	s_switch_time.stable_us = ft9001_deadline_elapsed_us(&sw->dl);
+	sw->state = FT9001_CPM_SWITCH_READY;
+
+	if (sw->cb != NULL) {
+		return ft9001_cpm_sysclk_switch_complete(sw);
 	}
+
+	return 0;
+}
+
+int ft9001_cpm_sysclk_switch_complete(struct ft9001_cpm_switch *sw)
+{
+	if (sw->state == FT9001_CPM_SWITCH_DONE) {
+		return sw->result;
+	}
+
+	return cpm_sysclk_switch_end(sw, cpm_sysclk_switch_commit(sw));
+}
+
+int ft9001_cpm_sysclk_source_set(enum ft9001_cpm_sysclk_source source, uint32_t timeout_us)
+{
+	struct ft9001_cpm_switch sw = {0};
+	int ret = ft9001_cpm_sysclk_switch_start(&sw, source, timeout_us);
+
+	if (ret != 0) {
+		return ret;
+	}
+
+	return ft9001_cpm_sysclk_switch_complete(&sw);
+}
+
+void ft9001_cpm_sysclk_switch_time_get(struct ft9001_cpm_switch_time *t)
+{
+	uint32_t key = ft9001_irq_lock();
+
+	*t = s_switch_time;
+
+	ft9001_irq_unlock(key);
+}
+
+static void cpm_hsosc_trim_write(enum ft9001_cpm_osc_freq freq, uint32_t trim)
+{
+	uint32_t key;
+
+	/* Keep the unlock window closed to everything else: the key sequence
+	 * must reach VCCCTMR back to back, and no other code may run with the
+	 * override open.
+	 */
+	key = ft9001_irq_lock();
+	cpm_unlock_override(CPM_VCCCTMR_OVERWR_OSC400M_TRIM);
+	FT9001_WRITE_REG(CPM->O400MTRIMR, trim);
+	cpm_lock_override();
+	ft9001_irq_unlock(key);
+
+	s_hsosc_nominal_hz = s_hsosc_trim_hz[freq];
+	s_hsosc_measured_hz = 0U;
+	s_hsosc_trim = freq;
+	s_hsosc_trim_loaded = true;
+}
+
+void ft9001_cpm_otp_trim_load(void)
+{
+	cpm_otp_parse();
+}
+
+bool ft9001_cpm_hsosc_freq_supported(enum ft9001_cpm_osc_freq freq)
+{
+	uint32_t trim;
+
+	return cpm_otp_trim_find(freq, &trim) == 0;
 }
 
 int ft9001_cpm_hsosc_trim_set(enum ft9001_cpm_osc_freq freq)
 {
+	uint32_t trim;
+	int ret;
+
+	/* Rejected before the clock is touched; OTP is not read again here. */
+	ret = cpm_otp_trim_find(freq, &trim);
+	if (ret != 0) {
+		return ret;
+	}
+
+	ret = ft9001_cpm_claim();
+	if (ret != 0) {
+		return ret;
+	}
+
 	/* The trim register may only be written while running from OSC8M. */
-	int ret = ft9001_cpm_sysclk_source_set(FT9001_CPM_SYSCLK_OSC8M, CPM_TRIM_SWITCH_POLLS);
+	ret = cpm_sysclk_switch_run(FT9001_CPM_SYSCLK_OSC8M, CPM_TRIM_SWITCH_TIMEOUT_US);
+	if (ret == 0) {
+		cpm_hsosc_trim_write(freq, trim);
+		cpm_clk_tree_update();
+	}
+
+	ft9001_cpm_release();
+
+	return ret;
+}
+
+int ft9001_cpm_hsosc_trim_get(enum ft9001_cpm_osc_freq *freq)
+{
+	if (!s_hsosc_trim_loaded) {
+		return -ENODATA;
+	}
+
+	*freq = s_hsosc_trim;
+
+	return 0;
+}
+
+bool ft9001_cpm_hsosc_is_on(void)
+{
+	return ft9001_cpm_osc_is_on(FT9001_CPM_OSC_HSOSC);
+}
+
+int ft9001_cpm_hsosc_disable(void)
+{
+	return ft9001_cpm_osc_disable(FT9001_CPM_OSC_HSOSC);
+}
+
+const struct ft9001_cpm_osc_desc *ft9001_cpm_osc_desc_get(enum ft9001_cpm_osc osc)
+{
+	if ((uint32_t)osc >= (uint32_t)FT9001_CPM_OSC_COUNT) {
+		return NULL;
+	}
+
+	return &s_osc_desc[osc];
+}
+
+/* Oscillator start, under a claim the caller already holds. */
+static int cpm_osc_enable(enum ft9001_cpm_osc osc, uint32_t timeout_us, uint32_t *stable_us)
+{
+	if ((uint32_t)osc >= (uint32_t)FT9001_CPM_OSC_COUNT) {
+		return -EINVAL;
+	}
+
+	ft9001_irq_reg_set(&CPM->OCSR, s_osc_desc[osc].en);
+
+	return cpm_wait_bits_set(&CPM->OCSR, s_osc_desc[osc].stable, timeout_us, stable_us);
+}
+
+int ft9001_cpm_osc_enable(enum ft9001_cpm_osc osc, uint32_t timeout_us, uint32_t *stable_us)
+{
+	int ret;
 
+	if ((uint32_t)osc >= (uint32_t)FT9001_CPM_OSC_COUNT) {
+		return -EINVAL;
+	}
+
+	ret = ft9001_cpm_claim();
 	if (ret != 0) {
 		return ret;
 	}
 
-	switch (freq) {
-	case FT9001_CPM_OSC_FREQ_320MHZ: {
-		uint32_t part = cpm_pick_otp_part();
-		uint32_t en_addr = OTP_BASE_TRIM_EN + part * OTP_PART_STRIDE;
-		uint32_t val_addr = OTP_BASE_TRIM_VALUE + part * OTP_PART_STRIDE;
+	ret = cpm_osc_enable(osc, timeout_us, stable_us);
+	ft9001_cpm_release();
 
-		if (*(volatile uint32_t *)en_addr != OTP_OSC320_TRIM_KEY) {
-			return -ENOENT;
-		}
+	return ret;
+}
+
+int ft9001_cpm_osc_disable(enum ft9001_cpm_osc osc)
+{
+	int ret;
 
-		cpm_unlock_override(CPM_VCCCTMR_OVERWR_OSC400M_TRIM);
-		FT9001_WRITE_REG(CPM->O400MTRIMR, *(volatile uint32_t *)val_addr);
-		cpm_lock_override();
+	if ((uint32_t)osc >= (uint32_t)FT9001_CPM_OSC_COUNT) {
+		return -EINVAL;
+	}
 
-		s_hsosc_nominal_hz = 320000000UL;
-		return 0;
+	/* Holding the CPM keeps a switch from selecting it meanwhile. */
+	ret = ft9001_cpm_claim();
+	if (ret != 0) {
+		return ret;
+	}
+
+	if (ft9001_cpm_osc_in_use(osc)) {
+		ret = -EBUSY;
+	} else {
+		ft9001_irq_reg_clear(&CPM->OCSR, s_osc_desc[osc].en);
+	}
+
+	ft9001_cpm_release();
+
+	return ret;
+}
+
+bool ft9001_cpm_osc_is_on(enum ft9001_cpm_osc osc)
+{
+	uint32_t mask;
+
+	if ((uint32_t)osc >= (uint32_t)FT9001_CPM_OSC_COUNT) {
+		return false;
+	}
+
+	mask = s_osc_desc[osc].en | s_osc_desc[osc].stable;
+
+	return (FT9001_READ_REG(CPM->OCSR) & mask) == mask;
+}
+
+bool ft9001_cpm_osc_in_use(enum ft9001_cpm_osc osc)
+{
+	uint32_t oscl = FT9001_READ_REG(CPM->CSWCFGR) & CPM_CSWCFGR_OSCL_SEL_ST_Msk;
+
+	switch (osc) {
+	case FT9001_CPM_OSC_HSOSC:
+		return ft9001_cpm_sysclk_source_get() == FT9001_CPM_SYSCLK_OSC400M;
+	case FT9001_CPM_OSC_PMU128K:
+		return oscl == CPM_CSWCFGR_OSCL_SEL_ST_PMU128K;
+	case FT9001_CPM_OSC_RTC32K:
+		return oscl == CPM_CSWCFGR_OSCL_SEL_ST_RTC32K;
+	default:
+		return false;
 	}
+}
+
+uint32_t ft9001_cpm_hsosc_freq_hz_get(void)
+{
+	return (s_hsosc_measured_hz != 0U) ? s_hsosc_measured_hz : s_hsosc_nominal_hz;
+}
+
+uint32_t ft9001_cpm_osc_freq_hz(enum ft9001_cpm_osc_freq freq)
+{
+	if ((uint32_t)freq >= (uint32_t)FT9001_CPM_OSC_FREQ_COUNT) {
+		return 0U;
+	}
+
+	return s_hsosc_trim_hz[freq];
+}
+
+uint32_t ft9001_cpm_oscl_freq_hz_get(void)
+{
+	return cpm_oscl_hz(FT9001_READ_REG(CPM->CSWCFGR));
+}
+
+int ft9001_cpm_oscl_source_set(enum ft9001_cpm_oscl_source source, uint32_t timeout_us)
+{
+	struct ft9001_deadline dl;
+	enum ft9001_cpm_osc osc;
+	uint32_t sel;
+	uint32_t sel_st;
+	int ret;
+
+	switch (source) {
+	case FT9001_CPM_OSCL_PMU128K:
+		osc = FT9001_CPM_OSC_PMU128K;
+		sel = CPM_CSWCFGR_OSCL_SEL_PMU128K;
+		sel_st = CPM_CSWCFGR_OSCL_SEL_ST_PMU128K;
+		break;
+	case FT9001_CPM_OSCL_RTC32K:
+		osc = FT9001_CPM_OSC_RTC32K;
+		sel = CPM_CSWCFGR_OSCL_SEL_RTC32K;
+		sel_st = CPM_CSWCFGR_OSCL_SEL_ST_RTC32K;
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	ret = ft9001_cpm_claim();
+	if (ret != 0) {
+		return ret;
+	}
+
+	ft9001_deadline_start(&dl, timeout_us);
+
+	ret = cpm_osc_enable(osc, timeout_us, NULL);
+	if (ret == 0) {
+		timeout_us = ft9001_deadline_left_us(&dl);
+
+		ft9001_irq_reg_modify(&CPM->CSWCFGR, CPM_CSWCFGR_OSCL_SEL_Msk, sel);
+		ret = ft9001_tick_wait_bits(&CPM->CSWCFGR, CPM_CSWCFGR_OSCL_SEL_ST_Msk, sel_st,
+					    timeout_us, NULL);
+
+		/* CLKOUT may be routed from OSCL. */
+		cpm_clk_tree_update();
+	}
+
+	ft9001_cpm_release();
+
+	return ret;
+}
+
+enum ft9001_cpm_oscl_source ft9001_cpm_oscl_source_get(void)
+{
+	return FT9001_READ_BIT(CPM->CSWCFGR, CPM_CSWCFGR_OSCL_SEL) ? FT9001_CPM_OSCL_RTC32K
+								     : FT9001_CPM_OSCL_PMU128K;
+}
+
+/* Total divide factor from HSOSC to the TC clock: SYS, IPS and TC dividers. */
+static uint32_t cpm_hsosc_to_tc_div(void)
+{
+	struct ft9001_cpm_clk_plan plan;
+
+	ft9001_cpm_clk_plan_get(&plan);
+
+	return (plan.sys_div + 1UL) * (plan.ips_div + 1UL) * (plan.tc_div + 1UL);
+}
+
+/* Wait for the reference counter to move, so the window starts on an edge. */
+static int cpm_cal_ref_edge(const struct ft9001_cpm_cal_counter *counter, uint32_t *ticks)
+{
+	uint32_t start = counter->ticks_get(counter->ctx);
+	struct ft9001_deadline dl;
+	bool late;
 
-	case FT9001_CPM_OSC_FREQ_400MHZ: {
-		uint32_t v = *(volatile uint32_t *)OTP_OSC400_TRIM_ADDR;
+	/* Two reference periods, rounded up. */
+	ft9001_deadline_start(&dl, (2000000U + counter->ref_hz - 1U) / counter->ref_hz);
 
-		if ((v & OTP_OSC_VALID_MASK) != OTP_OSC_VALID_TAG) {
-			return -ENOENT;
+	for (;;) {
+		late = ft9001_deadline_expired(&dl);
+		*ticks = counter->ticks_get(counter->ctx);
+		if (*ticks != start) {
+			return 0;
 		}
+		if (late) {
+			return -ETIMEDOUT;
+		}
+	}
+}
+
+/* Calibration proper, under a claim the caller already holds. */
+static int cpm_hsosc_measure(const struct ft9001_cpm_cal_counter *counter,
+			     enum ft9001_cpm_osc osc, uint32_t ref_ticks, uint32_t *hsosc_hz)
+{
+	struct ft9001_tc_ctx tc_ctx;
+	uint32_t ref_start;
+	uint32_t ref_now;
+	uint16_t tc_prev;
+	uint16_t tc_now;
+	uint64_t tc_counts = 0U;
+	uint64_t hz;
+	int ret;
 
-		cpm_unlock_override(CPM_VCCCTMR_OVERWR_OSC400M_TRIM);
-		FT9001_WRITE_REG(CPM->O400MTRIMR, v);
-		cpm_lock_override();
+	if (ft9001_cpm_sysclk_source_get() != FT9001_CPM_SYSCLK_OSC400M) {
+		return -ENOTSUP;
+	}
 
-		s_hsosc_nominal_hz = 400000000UL;
-		return 0;
+	ret = cpm_osc_enable(osc, CPM_CAL_REF_STABLE_TIMEOUT_US, NULL);
+	if (ret != 0) {
+		return ret;
+	}
+
+	/* Free-running down-counter over the full 16-bit range, finest prescaler. */
+	ft9001_tc_save(TC, &tc_ctx);
+	ft9001_tc_stop(TC);
+	ft9001_tc_prescaler_set(TC, FT9001_TC_PRESCALER_DIV16);
+	ft9001_tc_mode_set(TC, FT9001_TC_MODE_PERIODIC);
+	ft9001_tc_reload_set(TC, UINT16_MAX);
+	ft9001_tc_start(TC);
+
+	ret = cpm_cal_ref_edge(counter, &ref_start);
+	if (ret != 0) {
+		ft9001_tc_restore(TC, &tc_ctx);
+		return ret;
+	}
+
+	tc_prev = ft9001_tc_counter_get(TC);
+
+	/* Poll well inside one TC wrap so none is missed; the wrap period is at
+	 * least 2^20 HSOSC cycles.
+	 */
+	do {
+		ref_now = counter->ticks_get(counter->ctx);
+		tc_now = ft9001_tc_counter_get(TC);
+		tc_counts += (uint16_t)(tc_prev - tc_now);
+		tc_prev = tc_now;
+	} while ((uint32_t)(ref_now - ref_start) < ref_ticks);
+
+	ft9001_tc_restore(TC, &tc_ctx);
+
+	hz = (tc_counts * 16U * cpm_hsosc_to_tc_div() * counter->ref_hz) /
+	     (uint64_t)(uint32_t)(ref_now - ref_start);
+	if (hz == 0U || hz > UINT32_MAX) {
+		return -ETIMEDOUT;
 	}
 
+	s_hsosc_measured_hz = (uint32_t)hz;
+	cpm_clk_tree_update();
+
+	if (hsosc_hz != NULL) {
+		*hsosc_hz = s_hsosc_measured_hz;
+	}
+
+	return 0;
+}
+
+int ft9001_cpm_hsosc_calibrate(const struct ft9001_cpm_cal_counter *counter,
+			       uint32_t ref_ticks, uint32_t *hsosc_hz)
+{
+	enum ft9001_cpm_osc osc;
+	int ret;
+
+	if (counter == NULL || counter->ticks_get == NULL || counter->ref_hz == 0U ||
+	    ref_ticks == 0U) {
+		return -EINVAL;
+	}
+
+	switch (counter->ref) {
+	case FT9001_CPM_CAL_REF_RTC32K:
+		osc = FT9001_CPM_OSC_RTC32K;
+		break;
+	case FT9001_CPM_CAL_REF_OSCEXT:
+		osc = FT9001_CPM_OSC_OSCEXT;
+		break;
 	default:
 		return -EINVAL;
 	}
+
+	/* The source must not change under the measurement. */
+	ret = ft9001_cpm_claim();
+	if (ret != 0) {
+		return ret;
+	}
+
+	ret = cpm_hsosc_measure(counter, osc, ref_ticks, hsosc_hz);
+	ft9001_cpm_release();
+
+	return ret;
 }
 
-int ft9001_cpm_ips_div_set(uint32_t div)
+/* Plan that divider register values give with the enables in @p en. */
+static void cpm_clk_regs_decode(const struct ft9001_cpm_clk_regs *regs, uint32_t en,
+				struct ft9001_cpm_clk_plan *plan)
+{
+	uint32_t scdivr = regs->scdivr;
+	uint32_t pcdivr1 = regs->pcdivr1;
+	uint32_t pcdivr2 = regs->pcdivr2;
+	uint32_t pcdivr4 = regs->pcdivr4;
+
+	plan->sys_div = cpm_field_get(scdivr, CPM_SCDIVR_SYS_DIV_Msk, CPM_SCDIVR_SYS_DIV_Pos, 0U,
+				      en);
+	plan->trace_div = cpm_field_get(scdivr, CPM_SCDIVR_TRACE_DIV_Msk,
+					CPM_SCDIVR_TRACE_DIV_Pos, CPM_CDIVENR_TRACE_DIVEN, en);
+	plan->ahb3_div = cpm_field_get(pcdivr1, CPM_PCDIVR1_AHB3_DIV_Msk,
+				       CPM_PCDIVR1_AHB3_DIV_Pos, CPM_CDIVENR_AHB3_DIVEN, en);
+	plan->arith_div = cpm_field_get(pcdivr1, CPM_PCDIVR1_ARITH_DIV_Msk,
+					CPM_PCDIVR1_ARITH_DIV_Pos, CPM_CDIVENR_ARITH_DIVEN, en);
+	plan->ips_div = cpm_field_get(pcdivr1, CPM_PCDIVR1_IPS_DIV_Msk, CPM_PCDIVR1_IPS_DIV_Pos,
+				      CPM_CDIVENR_IPS_DIVEN, en);
+	plan->tc_div = cpm_field_get(pcdivr2, CPM_PCDIVR2_TC_DIV_Msk, CPM_PCDIVR2_TC_DIV_Pos,
+				     CPM_CDIVENR_TC_DIVEN, en);
+	plan->adc_div = cpm_field_get(pcdivr2, CPM_PCDIVR2_ADC_DIV_Msk, CPM_PCDIVR2_ADC_DIV_Pos,
+				      CPM_CDIVENR_ADC_DIVEN, en);
+	plan->mcc_div = cpm_field_get(pcdivr2, CPM_PCDIVR2_MCC_DIV_Msk, CPM_PCDIVR2_MCC_DIV_Pos,
+				      CPM_CDIVENR_MCC_DIVEN, en);
+	plan->mesh_div = cpm_field_get(pcdivr2, CPM_PCDIVR2_MESH_DIV_Msk,
+				       CPM_PCDIVR2_MESH_DIV_Pos, CPM_CDIVENR_MESH_DIVEN, en);
+	plan->i2s_m_div = cpm_field_get(pcdivr4, CPM_PCDIVR4_I2S_M_DIV_Msk,
+					CPM_PCDIVR4_I2S_M_DIV_Pos, CPM_CDIVENR_I2S_M_DIVEN, en);
+	plan->i2s_s_div = cpm_field_get(pcdivr4, CPM_PCDIVR4_I2S_S_DIV_Msk,
+					CPM_PCDIVR4_I2S_S_DIV_Pos, CPM_CDIVENR_I2S_S_DIVEN, en);
+}
+
+void ft9001_cpm_clk_plan_get(struct ft9001_cpm_clk_plan *plan)
 {
-	/* 4-bit field: 0..15 divides by (N + 1) */
-	if (div > 0xFUL) {
+	struct ft9001_cpm_clk_regs regs = {
+		.scdivr = FT9001_READ_REG(CPM->SCDIVR),
+		.pcdivr1 = FT9001_READ_REG(CPM->PCDIVR1),
+		.pcdivr2 = FT9001_READ_REG(CPM->PCDIVR2),
+		.pcdivr4 = FT9001_READ_REG(CPM->PCDIVR4),
+	};
+
+	cpm_clk_regs_decode(&regs, FT9001_READ_REG(CPM->CDIVENR), plan);
+}
+
+int ft9001_cpm_clk_plan_check(const struct ft9001_cpm_clk_plan *plan, uint32_t src_hz,
+			      uint32_t hz[FT9001_CPM_CLK_COUNT])
+{
+	uint32_t cswcfgr = FT9001_READ_REG(CPM->CSWCFGR);
+	uint32_t out[FT9001_CPM_CLK_COUNT];
+
+	if (plan->sys_div > 0xFFUL || plan->trace_div > 0xFFUL || plan->ahb3_div > 0xFUL ||
+	    plan->arith_div > 0xFUL || plan->ips_div > 0xFUL || plan->tc_div > 0xFUL ||
+	    plan->adc_div > 0xFUL || plan->mcc_div > 0xFUL || plan->mesh_div > 0xFUL ||
+	    plan->i2s_m_div > 0xFFUL || plan->i2s_s_div > 0xFFUL) {
 		return -EINVAL;
 	}
 
-	FT9001_SET_BIT(CPM->CDIVENR, CPM_CDIVENR_IPS_DIVEN);
+	if (src_hz == 0U) {
+		src_hz = cpm_sys_base_hz(cswcfgr);
+	}
 
-	FT9001_MODIFY_REG(CPM->PCDIVR1, CPM_PCDIVR1_IPS_DIV_Msk,
-			  (div << CPM_PCDIVR1_IPS_DIV_Pos));
+	if (hz == NULL) {
+		hz = out;
+	}
 
-	FT9001_SET_BIT(CPM->CDIVUPDR, CPM_CDIVUPDR_PERDIV_UPD);
+	cpm_clk_plan_hz(plan, src_hz, hz);
+	hz[FT9001_CPM_CLK_CLKOUT] = cpm_clkout_hz(cswcfgr, hz);
+
+	/* Every other plan domain divides one of these two down. */
+	if (hz[FT9001_CPM_CLK_SYS] > FT9001_CPM_SYS_MAX_HZ ||
+	    hz[FT9001_CPM_CLK_IPS] > FT9001_CPM_IPS_MAX_HZ) {
+		return -ERANGE;
+	}
 
 	return 0;
 }
 
-uint32_t ft9001_cpm_sysclk_freq_hz_get(void)
+/* Tell pre-change listeners about a plan about to be written. */
+static void cpm_clk_plan_pre_notify(const struct ft9001_cpm_clk_plan *plan)
 {
-	uint32_t base_hz;
-	uint32_t sys_div;
-	enum ft9001_cpm_sysclk_source clk_src = ft9001_cpm_sysclk_source_get();
+	uint32_t next[FT9001_CPM_CLK_COUNT];
+
+	cpm_clk_plan_predict(plan, cpm_sys_base_hz(FT9001_READ_REG(CPM->CSWCFGR)), next);
+	cpm_clk_pre_notify(next);
+}
+
+/* Stage every plan field and latch them with one update. The whole sequence
+ * runs with interrupts masked so that CLKOUT, which shares SCDIVR and the
+ * update register, cannot slip in between.
+ */
+static void cpm_clk_regs_write(const struct ft9001_cpm_clk_regs *regs)
+{
+	uint32_t key = ft9001_irq_lock();
+
+	/* A divider switched on still holds its previously latched value, so
+	 * this can only slow domains down until the update below.
+	 */
+	FT9001_SET_BIT(CPM->CDIVENR, CPM_PLAN_DIVEN);
 
-	base_hz = (clk_src == FT9001_CPM_SYSCLK_OSC8M) ? 8000000UL : s_hsosc_nominal_hz;
-	sys_div = (FT9001_READ_REG(CPM->SCDIVR) & CPM_SCDIVR_SYS_DIV_Msk) >>
-		  CPM_SCDIVR_SYS_DIV_Pos;
+	FT9001_MODIFY_REG(CPM->SCDIVR, CPM_PLAN_SCDIVR_MSK, regs->scdivr & CPM_PLAN_SCDIVR_MSK);
+	FT9001_MODIFY_REG(CPM->PCDIVR1, CPM_PLAN_PCDIVR1_MSK, regs->pcdivr1 & CPM_PLAN_PCDIVR1_MSK);
+	FT9001_MODIFY_REG(CPM->PCDIVR2, CPM_PLAN_PCDIVR2_MSK, regs->pcdivr2 & CPM_PLAN_PCDIVR2_MSK);
+	FT9001_MODIFY_REG(CPM->PCDIVR4, CPM_PLAN_PCDIVR4_MSK, regs->pcdivr4 & CPM_PLAN_PCDIVR4_MSK);
 
-	return base_hz / (sys_div + 1UL);
+	/* One write latches every staged field. */
+	FT9001_WRITE_REG(CPM->CDIVUPDR, CPM_CDIVUPDR_SYSDIV_UPD | CPM_CDIVUPDR_PERDIV_UPD);
+
+	ft9001_irq_unlock(key);
+
+	cpm_clk_tree_update();
 }
 
-uint32_t ft9001_cpm_ips_freq_hz_get(void)
+/* Check, pack and write a plan under a claim the caller already holds. */
+static int cpm_clk_plan_commit(const struct ft9001_cpm_clk_plan *plan)
 {
-	uint32_t ips_div;
-	uint32_t sysclk_hz = ft9001_cpm_sysclk_freq_hz_get();
+	struct ft9001_cpm_clk_regs regs;
+	int ret = ft9001_cpm_clk_plan_check(plan, 0U, NULL);
 
-	if (!FT9001_READ_BIT(CPM->CDIVENR, CPM_CDIVENR_IPS_DIVEN)) {
-		return sysclk_hz;
+	if (ret != 0) {
+		return ret;
+	}
+
+	regs.scdivr = CPM_SCDIVR_SYS_DIV_VAL(plan->sys_div) |
+		      CPM_SCDIVR_TRACE_DIV_VAL(plan->trace_div);
+	regs.pcdivr1 = (plan->ahb3_div << CPM_PCDIVR1_AHB3_DIV_Pos) |
+		       (plan->arith_div << CPM_PCDIVR1_ARITH_DIV_Pos) |
+		       (plan->ips_div << CPM_PCDIVR1_IPS_DIV_Pos);
+	regs.pcdivr2 = (plan->tc_div << CPM_PCDIVR2_TC_DIV_Pos) |
+		       (plan->mesh_div << CPM_PCDIVR2_MESH_DIV_Pos) |
+		       (plan->adc_div << CPM_PCDIVR2_ADC_DIV_Pos) |
+		       (plan->mcc_div << CPM_PCDIVR2_MCC_DIV_Pos);
+	regs.pcdivr4 = (plan->i2s_s_div << CPM_PCDIVR4_I2S_S_DIV_Pos) |
+		       (plan->i2s_m_div << CPM_PCDIVR4_I2S_M_DIV_Pos);
+
+	cpm_clk_plan_pre_notify(plan);
+	cpm_clk_regs_write(&regs);
+
+	return 0;
+}
+
+int ft9001_cpm_clk_plan_apply(const struct ft9001_cpm_clk_plan *plan)
+{
+	int ret = ft9001_cpm_claim();
+
+	if (ret != 0) {
+		return ret;
+	}
+
+	ret = cpm_clk_plan_commit(plan);
+	ft9001_cpm_release();
+
+	return ret;
+}
+
+int ft9001_cpm_clk_regs_write(const struct ft9001_cpm_clk_regs *regs)
+{
+	struct ft9001_cpm_clk_plan plan;
+	int ret = ft9001_cpm_claim();
+
+	if (ret != 0) {
+		return ret;
+	}
+
+	/* Every plan divider ends up enabled, so decode as such. */
+	cpm_clk_regs_decode(regs, CPM_PLAN_DIVEN, &plan);
+	cpm_clk_plan_pre_notify(&plan);
+	cpm_clk_regs_write(regs);
+	ft9001_cpm_release();
+
+	return 0;
+}
+
+/* Swap the IPS and, unless NULL, the SYS divider into the current plan and
+ * commit it, under one claim so a concurrent plan is not partly undone.
+ */
+static int cpm_clk_plan_div_set(const uint32_t *sys_div, uint32_t ips_div)
+{
+	struct ft9001_cpm_clk_plan plan;
+	int ret = ft9001_cpm_claim();
+
+	if (ret != 0) {
+		return ret;
+	}
+
+	ft9001_cpm_clk_plan_get(&plan);
+	if (sys_div != NULL) {
+		plan.sys_div = *sys_div;
 	}
+	plan.ips_div = ips_div;
+
+	ret = cpm_clk_plan_commit(&plan);
+	ft9001_cpm_release();
 
-	ips_div = (FT9001_READ_REG(CPM->PCDIVR1) & CPM_PCDIVR1_IPS_DIV_Msk) >>
-		  CPM_PCDIVR1_IPS_DIV_Pos;
+	return ret;
+}
+
+int ft9001_cpm_ips_div_set(uint32_t div)
+{
+	return cpm_clk_plan_div_set(NULL, div);
+}
+
+int ft9001_cpm_sys_ips_div_set(uint32_t sys_div, uint32_t ips_div)
+{
+	return cpm_clk_plan_div_set(&sys_div, ips_div);
+}
+
+uint32_t ft9001_cpm_sys_div_get(void)
+{
+	return (FT9001_READ_REG(CPM->SCDIVR) & CPM_SCDIVR_SYS_DIV_Msk) >> CPM_SCDIVR_SYS_DIV_Pos;
+}
+
+uint32_t ft9001_cpm_ips_div_get(void)
+{
+	if (!FT9001_READ_BIT(CPM->CDIVENR, CPM_CDIVENR_IPS_DIVEN)) {
+		return 0U;
+	}
 
-	return sysclk_hz / (ips_div + 1UL);
+	return (FT9001_READ_REG(CPM->PCDIVR1) & CPM_PCDIVR1_IPS_DIV_Msk) >>
+	       CPM_PCDIVR1_IPS_DIV_Pos;
 }
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2026, FocalTech Systems CO.,Ltd
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <stddef.h>
+
+#include "ft9001_cpm.h"
+#include "ft9001_cpm_clkout.h"
+#include "ft9001_irq.h"
+#include "ft9001_tick.h"
+
+/* Timeout for CLKOUT_SEL_ST to follow; a few cycles of the slowest source. */
+#define CLKOUT_SEL_TIMEOUT_US (1000U)
+
+static uint32_t clkout_src_hz(enum ft9001_cpm_clkout_src src)
+{
+	switch (src) {
+	case FT9001_CPM_CLKOUT_SYS:
+		return ft9001_cpm_clk_freq_hz_get(FT9001_CPM_CLK_SYS);
+	case FT9001_CPM_CLKOUT_ARITH:
+		return ft9001_cpm_clk_freq_hz_get(FT9001_CPM_CLK_ARITH);
+	case FT9001_CPM_CLKOUT_OSCL:
+		return ft9001_cpm_oscl_freq_hz_get();
+	default:
+		/* The NFC PLL is not modelled. */
+		return 0U;
+	}
+}
+
+int ft9001_cpm_clkout_set(enum ft9001_cpm_clkout_src src, uint32_t div, uint32_t *out_hz)
+{
+	uint32_t key;
+	int ret;
+
+	if ((uint32_t)src >= (uint32_t)FT9001_CPM_CLKOUT_COUNT || div > FT9001_CPM_CLKOUT_DIV_MAX) {
+		return -EINVAL;
+	}
+
+	/* SYSDIV_UPD relatches the whole of SCDIVR; SYS and TRACE keep their
+	 * values, so only CLKOUT changes. Masked so a divider plan cannot stage
+	 * SCDIVR in between.
+	 */
+	key = ft9001_irq_lock();
+	FT9001_SET_BIT(CPM->CDIVENR, CPM_CDIVENR_CLKOUT_DIVEN);
+	FT9001_MODIFY_REG(CPM->SCDIVR, CPM_SCDIVR_CLKOUT_DIV_Msk, CPM_SCDIVR_CLKOUT_DIV_VAL(div));
+	FT9001_WRITE_REG(CPM->CDIVUPDR, CPM_CDIVUPDR_SYSDIV_UPD);
+	ft9001_irq_unlock(key);
+
+	ft9001_irq_reg_modify(&CPM->CSWCFGR, CPM_CSWCFGR_CLKOUT_SEL_Msk,
+			      (uint32_t)src << CPM_CSWCFGR_CLKOUT_SEL_Pos);
+	ret = ft9001_tick_wait_bits(&CPM->CSWCFGR, CPM_CSWCFGR_CLKOUT_SEL_ST_Msk,
+				    (1UL << (uint32_t)src) << CPM_CSWCFGR_CLKOUT_SEL_ST_Pos,
+				    CLKOUT_SEL_TIMEOUT_US, NULL);
+
+	ft9001_cpm_clk_tree_refresh();
+
+	if (out_hz != NULL) {
+		*out_hz = ft9001_cpm_clk_freq_hz_get(FT9001_CPM_CLK_CLKOUT);
+	}
+
+	return ret;
+}
+
+int ft9001_cpm_clkout_hz_set(enum ft9001_cpm_clkout_src src, uint32_t max_hz,
+			     uint32_t *out_hz)
+{
+	uint32_t src_hz;
+	uint32_t factor;
+
+	if ((uint32_t)src >= (uint32_t)FT9001_CPM_CLKOUT_COUNT || max_hz == 0U) {
+		return -EINVAL;
+	}
+
+	src_hz = clkout_src_hz(src);
+	if (src_hz == 0U) {
+		return -ENODATA;
+	}
+
+	factor = (src_hz / max_hz) + ((src_hz % max_hz) != 0U ? 1U : 0U);
+	if (factor > FT9001_CPM_CLKOUT_DIV_MAX + 1UL) {
+		return -ERANGE;
+	}
+
+	return ft9001_cpm_clkout_set(src, factor - 1U, out_hz);
+}
+
+enum ft9001_cpm_clkout_src ft9001_cpm_clkout_get(uint32_t *div)
+{
+	uint32_t sel = (FT9001_READ_REG(CPM->CSWCFGR) & CPM_CSWCFGR_CLKOUT_SEL_Msk) >>
+		       CPM_CSWCFGR_CLKOUT_SEL_Pos;
+
+	if (div != NULL) {
+		*div = FT9001_READ_BIT(CPM->CDIVENR, CPM_CDIVENR_CLKOUT_DIVEN)
+			       ? (FT9001_READ_REG(CPM->SCDIVR) & CPM_SCDIVR_CLKOUT_DIV_Msk) >>
+					 CPM_SCDIVR_CLKOUT_DIV_Pos
+			       : 0U;
+	}
+
+	return (enum ft9001_cpm_clkout_src)sel;
+}
+
+int ft9001_cpm_clkout_error_ppm(uint32_t measured_hz, int32_t *err_ppm)
+{
+	uint32_t expected = ft9001_cpm_clk_freq_hz_get(FT9001_CPM_CLK_CLKOUT);
+	int64_t ppm;
+
+	if (expected == 0U) {
+		return -ENODATA;
+	}
+
+	ppm = (((int64_t)measured_hz - (int64_t)expected) * 1000000LL) / (int64_t)expected;
+	if (ppm > INT32_MAX) {
+		ppm = INT32_MAX;
+	} else if (ppm < INT32_MIN) {
+		ppm = INT32_MIN;
+	}
+
+	*err_ppm = (int32_t)ppm;
+
+	return 0;
+}
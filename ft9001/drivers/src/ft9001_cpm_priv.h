@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2026, FocalTech Systems CO.,Ltd
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * CPM internals shared between the CPM sources; not part of the HAL API.
+ */
+
+#ifndef FT9001_CPM_PRIV_H_
+#define FT9001_CPM_PRIV_H_
+
+#include <stdint.h>
+
+#include "ft9001_cpm.h"
+
+/* Registers and OCSR bits of one oscillator. */
+struct ft9001_cpm_osc_desc {
+	volatile uint32_t *stimer;
+	uint32_t en;
+	uint32_t stable;
+};
+
+/* Take ownership of the CPM for a reconfiguration that spans several register
+ * accesses or waits. Never blocks: a second caller gets -EBUSY instead of
+ * interleaving with the first.
+ */
+int ft9001_cpm_claim(void);
+
+/* Give up the ownership taken by ft9001_cpm_claim(). */
+void ft9001_cpm_release(void);
+
+/* Descriptor of @p osc, or NULL for an unknown oscillator. */
+const struct ft9001_cpm_osc_desc *ft9001_cpm_osc_desc_get(enum ft9001_cpm_osc osc);
+
+#endif /* FT9001_CPM_PRIV_H_ */
@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2026, FocalTech Systems CO.,Ltd
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <stddef.h>
+
+#include "ft9001_cpm.h"
+#include "ft9001_cpm_priv.h"
+#include "ft9001_cpm_stime.h"
+#include "ft9001_irq.h"
+#include "ft9001_tc.h"
+#include "ft9001_tick.h"
+
+#define STIME_CLK_MHZ (8U)
+#define STIME_MAX_US  (CPM_STIMER_STIME_Msk / STIME_CLK_MHZ)
+
+/* Timeout for the oscillator to drop its STABLE flag after being disabled. */
+#define STIME_STOP_TIMEOUT_US (1000U)
+
+/* Stable times found at first use, before the HAL wrote any; the floor for
+ * ft9001_cpm_stime_tune(). Bit n of s_stime_reset_valid covers oscillator n.
+ */
+static uint32_t s_stime_reset[FT9001_CPM_OSC_COUNT];
+static uint32_t s_stime_reset_valid;
+
+/* Record the reset default of @p osc before its first write. */
+static void stime_reset_capture(enum ft9001_cpm_osc osc, const struct ft9001_cpm_osc_desc *o)
+{
+	uint32_t bit = 1UL << (uint32_t)osc;
+	uint32_t key = ft9001_irq_lock();
+
+	if ((s_stime_reset_valid & bit) == 0U) {
+		s_stime_reset[osc] = (FT9001_READ_REG(*o->stimer) & CPM_STIMER_STIME_Msk) >>
+				     CPM_STIMER_STIME_Pos;
+		s_stime_reset_valid |= bit;
+	}
+
+	ft9001_irq_unlock(key);
+}
+
+uint32_t ft9001_cpm_stime_us_get(enum ft9001_cpm_osc osc)
+{
+	const struct ft9001_cpm_osc_desc *o = ft9001_cpm_osc_desc_get(osc);
+	uint32_t cycles;
+
+	if (o == NULL) {
+		return 0U;
+	}
+
+	cycles = (FT9001_READ_REG(*o->stimer) & CPM_STIMER_STIME_Msk) >> CPM_STIMER_STIME_Pos;
+
+	return (cycles + STIME_CLK_MHZ - 1U) / STIME_CLK_MHZ;
+}
+
+int ft9001_cpm_stime_us_set(enum ft9001_cpm_osc osc, uint32_t us)
+{
+	const struct ft9001_cpm_osc_desc *o = ft9001_cpm_osc_desc_get(osc);
+
+	if (o == NULL || us > STIME_MAX_US) {
+		return -EINVAL;
+	}
+
+	stime_reset_capture(osc, o);
+	FT9001_MODIFY_REG(*o->stimer, CPM_STIMER_STIME_Msk,
+			  (us * STIME_CLK_MHZ) << CPM_STIMER_STIME_Pos);
+
+	return 0;
+}
+
+/* Stop the oscillator, then count TC ticks from its enable to its STABLE flag,
+ * with the stable timer at zero. The caller restores enable and timer.
+ */
+static int stime_settle_count(const struct ft9001_cpm_osc_desc *o, uint64_t tc_limit,
+			      uint64_t *tc_counts)
+{
+	struct ft9001_tc_ctx tc_ctx;
+	uint16_t tc_prev;
+	uint16_t tc_now;
+	int ret;
+
+	ft9001_irq_reg_clear(&CPM->OCSR, o->en);
+	ret = ft9001_tick_wait_bits(&CPM->OCSR, o->stable, 0U, STIME_STOP_TIMEOUT_US, NULL);
+	if (ret != 0) {
+		return ret;
+	}
+
+	FT9001_MODIFY_REG(*o->stimer, CPM_STIMER_STIME_Msk, 0U);
+
+	ft9001_tc_save(TC, &tc_ctx);
+	ft9001_tc_stop(TC);
+	ft9001_tc_prescaler_set(TC, FT9001_TC_PRESCALER_DIV16);
+	ft9001_tc_mode_set(TC, FT9001_TC_MODE_PERIODIC);
+	ft9001_tc_reload_set(TC, UINT16_MAX);
+	ft9001_tc_start(TC);
+
+	*tc_counts = 0U;
+	tc_prev = ft9001_tc_counter_get(TC);
+	ft9001_irq_reg_set(&CPM->OCSR, o->en);
+
+	while (FT9001_READ_BIT(CPM->OCSR, o->stable) == 0U) {
+		tc_now = ft9001_tc_counter_get(TC);
+		*tc_counts += (uint16_t)(tc_prev - tc_now);
+		tc_prev = tc_now;
+
+		if (*tc_counts > tc_limit) {
+			ft9001_tc_restore(TC, &tc_ctx);
+			return -ETIMEDOUT;
+		}
+	}
+
+	ft9001_tc_restore(TC, &tc_ctx);
+
+	return 0;
+}
+
+/* Measurement proper, under a CPM claim the caller already holds, so the
+ * oscillator cannot be selected between the in-use check and the restore.
+ */
+static int stime_measure(enum ft9001_cpm_osc osc, const struct ft9001_cpm_osc_desc *o,
+			 uint32_t *settle_us)
+{
+	uint32_t saved_stimer;
+	uint32_t was_on;
+	uint32_t tc_hz;
+	uint64_t tc_counts;
+	uint64_t tc_limit;
+	int ret;
+
+	if (ft9001_cpm_osc_in_use(osc)) {
+		return -EBUSY;
+	}
+
+	tc_hz = ft9001_cpm_clk_freq_hz_get(FT9001_CPM_CLK_TC);
+	if (tc_hz == 0U) {
+		return -EINVAL;
+	}
+
+	/* Give up once the settle time would no longer fit the register. */
+	tc_limit = ((uint64_t)STIME_MAX_US * tc_hz) / (16U * 1000000ULL) + 1U;
+
+	stime_reset_capture(osc, o);
+	saved_stimer = FT9001_READ_REG(*o->stimer);
+	was_on = FT9001_READ_BIT(CPM->OCSR, o->en);
+
+	ret = stime_settle_count(o, tc_limit, &tc_counts);
+	if (ret == 0) {
+		*settle_us = (uint32_t)(((tc_counts * 16U * 1000000ULL) + tc_hz - 1U) / tc_hz);
+	}
+
+	FT9001_WRITE_REG(*o->stimer, saved_stimer);
+	if (was_on == 0U) {
+		ft9001_irq_reg_clear(&CPM->OCSR, o->en);
+	} else {
+		ft9001_irq_reg_set(&CPM->OCSR, o->en);
+	}
+
+	return ret;
+}
+
+int ft9001_cpm_osc_settle_measure(enum ft9001_cpm_osc osc, uint32_t *settle_us)
+{
+	const struct ft9001_cpm_osc_desc *o = ft9001_cpm_osc_desc_get(osc);
+	int ret;
+
+	if (o == NULL || settle_us == NULL) {
+		return -EINVAL;
+	}
+
+	ret = ft9001_cpm_claim();
+	if (ret != 0) {
+		return ret;
+	}
+
+	ret = stime_measure(osc, o, settle_us);
+	ft9001_cpm_release();
+
+	return ret;
+}
+
+int ft9001_cpm_stime_tune(enum ft9001_cpm_osc osc, uint32_t margin_pct, uint32_t *stime_us)
+{
+	const struct ft9001_cpm_osc_desc *o = ft9001_cpm_osc_desc_get(osc);
+	uint32_t settle_us;
+	uint32_t floor_us;
+	uint64_t us = 0U;
+	int ret;
+
+	if (o == NULL) {
+		return -EINVAL;
+	}
+
+	/* One claim over measure and program, so nothing selects the oscillator
+	 * in between.
+	 */
+	ret = ft9001_cpm_claim();
+	if (ret != 0) {
+		return ret;
+	}
+
+	ret = stime_measure(osc, o, &settle_us);
+	if (ret == 0) {
+		us = ((uint64_t)settle_us * (100U + (uint64_t)margin_pct) + 99U) / 100U;
+		floor_us = (s_stime_reset[osc] + STIME_CLK_MHZ - 1U) / STIME_CLK_MHZ;
+		if (us < floor_us) {
+			us = floor_us;
+		}
+		ret = (us > STIME_MAX_US) ? -EINVAL : ft9001_cpm_stime_us_set(osc, (uint32_t)us);
+	}
+
+	ft9001_cpm_release();
+
+	if (ret == 0 && stime_us != NULL) {
+		*stime_us = (uint32_t)us;
+	}
+
+	return ret;
+}
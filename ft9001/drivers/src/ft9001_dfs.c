@@ -0,0 +1,366 @@
+/*
+ * Copyright (c) 2026, FocalTech Systems CO.,Ltd
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <stddef.h>
+
+#include "ft9001_cpm_stime.h"
+#include "ft9001_dfs.h"
+#include "ft9001_tick.h"
+#include "ft9001_uart.h"
+
+/* Timeout for each source switch, covering the high-speed oscillator's start-up
+ * and stable time with a wide margin.
+ */
+#define DFS_SWITCH_TIMEOUT_US (50000U)
+
+#define DFS_OSC8M_HZ (8000000UL)
+
+/* Per-step cost budget in microseconds, used for the latency estimate. These
+ * are worst-case figures for the step, not measurements. Starting the
+ * high-speed oscillator costs its programmed stable time instead.
+ */
+#define DFS_COST_SWITCH_US      (2U)
+#define DFS_COST_TRIM_US        (10U)
+#define DFS_COST_DIV_US         (1U)
+
+static const struct ft9001_dfs_opp s_opp_table[FT9001_DFS_LEVEL_COUNT] = {
+	[FT9001_DFS_LEVEL_IDLE] = {
+		.name = "idle",
+		.source = FT9001_CPM_SYSCLK_OSC8M,
+		.hsosc_freq = FT9001_CPM_OSC_FREQ_320MHZ,
+		.sys_div = 0U,
+		.ips_div = 0U,
+		.hsosc_off = true,
+	},
+	[FT9001_DFS_LEVEL_NOMINAL] = {
+		.name = "nominal",
+		.source = FT9001_CPM_SYSCLK_OSC400M,
+		.hsosc_freq = FT9001_CPM_OSC_FREQ_320MHZ,
+		.sys_div = 1U,
+		.ips_div = 1U,
+		.hsosc_off = false,
+	},
+	[FT9001_DFS_LEVEL_BOOST] = {
+		.name = "boost",
+		.source = FT9001_CPM_SYSCLK_OSC400M,
+		.hsosc_freq = FT9001_CPM_OSC_FREQ_400MHZ,
+		.sys_div = 1U,
+		.ips_div = 1U,
+		.hsosc_off = false,
+	},
+};
+
+/* Steps a transition has to perform, derived from the current hardware state */
+struct dfs_plan {
+	bool trim;
+	bool to_osc8m;
+	bool div;
+	bool to_hsosc;
+	bool hsosc_start;
+	bool hsosc_stop;
+};
+
+static bool dfs_trim_matches(enum ft9001_cpm_osc_freq freq)
+{
+	enum ft9001_cpm_osc_freq loaded;
+
+	return ft9001_cpm_hsosc_trim_get(&loaded) == 0 && loaded == freq;
+}
+
+static void dfs_plan_build(const struct ft9001_dfs_opp *opp, struct dfs_plan *plan)
+{
+	enum ft9001_cpm_sysclk_source src = ft9001_cpm_sysclk_source_get();
+	bool hsosc_on = ft9001_cpm_hsosc_is_on();
+
+	plan->trim = (opp->source == FT9001_CPM_SYSCLK_OSC400M) &&
+		     !dfs_trim_matches(opp->hsosc_freq);
+
+	/* A trim load drops to OSC8M by itself. */
+	if (plan->trim) {
+		src = FT9001_CPM_SYSCLK_OSC8M;
+	}
+
+	plan->to_osc8m = (opp->source == FT9001_CPM_SYSCLK_OSC8M) &&
+			 (src != FT9001_CPM_SYSCLK_OSC8M);
+	plan->div = (ft9001_cpm_sys_div_get() != opp->sys_div) ||
+		    (ft9001_cpm_ips_div_get() != opp->ips_div);
+	plan->to_hsosc = (opp->source == FT9001_CPM_SYSCLK_OSC400M) &&
+			 (src != FT9001_CPM_SYSCLK_OSC400M);
+	plan->hsosc_start = plan->to_hsosc && !hsosc_on;
+	plan->hsosc_stop = opp->hsosc_off && hsosc_on;
+}
+
+static uint32_t dfs_plan_cost_us(const struct dfs_plan *plan)
+{
+	uint32_t us = 0U;
+
+	if (plan->trim) {
+		us += DFS_COST_SWITCH_US + DFS_COST_TRIM_US;
+	}
+	if (plan->to_osc8m) {
+		us += DFS_COST_SWITCH_US;
+	}
+	if (plan->div) {
+		us += DFS_COST_DIV_US;
+	}
+	if (plan->hsosc_start) {
+		us += ft9001_cpm_stime_us_get(FT9001_CPM_OSC_HSOSC);
+	}
+	if (plan->to_hsosc) {
+		us += DFS_COST_SWITCH_US;
+	}
+
+	return us;
+}
+
+/* Current dividers with the level's SYS and IPS fields swapped in. */
+static void dfs_clk_plan_build(const struct ft9001_dfs_opp *opp, struct ft9001_cpm_clk_plan *clk)
+{
+	ft9001_cpm_clk_plan_get(clk);
+	clk->sys_div = opp->sys_div;
+	clk->ips_div = opp->ips_div;
+}
+
+/* Nominal source frequency of a level. */
+static uint32_t dfs_opp_src_hz(const struct ft9001_dfs_opp *opp)
+{
+	if (opp->source == FT9001_CPM_SYSCLK_OSC8M) {
+		return DFS_OSC8M_HZ;
+	}
+
+	return ft9001_cpm_osc_freq_hz(opp->hsosc_freq);
+}
+
+const struct ft9001_dfs_opp *ft9001_dfs_opp_get(enum ft9001_dfs_level level)
+{
+	if ((uint32_t)level >= (uint32_t)FT9001_DFS_LEVEL_COUNT) {
+		return NULL;
+	}
+
+	return &s_opp_table[level];
+}
+
+bool ft9001_dfs_level_available(enum ft9001_dfs_level level)
+{
+	const struct ft9001_dfs_opp *opp = ft9001_dfs_opp_get(level);
+
+	if (opp == NULL) {
+		return false;
+	}
+
+	return opp->source == FT9001_CPM_SYSCLK_OSC8M ||
+	       ft9001_cpm_hsosc_freq_supported(opp->hsosc_freq);
+}
+
+static int dfs_plan_run(const struct ft9001_dfs_opp *opp, const struct ft9001_cpm_clk_plan *clk,
+			const struct dfs_plan *plan)
+{
+	int ret;
+
+	if (plan->trim) {
+		ret = ft9001_cpm_hsosc_trim_set(opp->hsosc_freq);
+		if (ret != 0) {
+			return ret;
+		}
+	}
+
+	/* Slow the source down before the dividers shrink ... */
+	if (plan->to_osc8m) {
+		ret = ft9001_cpm_sysclk_source_set(FT9001_CPM_SYSCLK_OSC8M, DFS_SWITCH_TIMEOUT_US);
+		if (ret != 0) {
+			return ret;
+		}
+	}
+
+	if (plan->div) {
+		ret = ft9001_cpm_clk_plan_apply(clk);
+		if (ret != 0) {
+			return ret;
+		}
+	}
+
+	/* ... and only speed it up once the dividers have grown. */
+	if (plan->to_hsosc) {
+		ret = ft9001_cpm_sysclk_source_set(FT9001_CPM_SYSCLK_OSC400M,
+						   DFS_SWITCH_TIMEOUT_US);
+		if (ret != 0) {
+			return ret;
+		}
+	}
+
+	if (plan->hsosc_stop) {
+		return ft9001_cpm_hsosc_disable();
+	}
+
+	return 0;
+}
+
+/* Operating point the hardware is at, to roll a failed transition back to.
+ * False when it cannot be restored: on the high-speed oscillator with a trim
+ * the HAL did not load.
+ */
+static bool dfs_opp_capture(struct ft9001_dfs_opp *opp)
+{
+	opp->name = NULL;
+	opp->source = ft9001_cpm_sysclk_source_get();
+	opp->sys_div = ft9001_cpm_sys_div_get();
+	opp->ips_div = ft9001_cpm_ips_div_get();
+	opp->hsosc_off = !ft9001_cpm_hsosc_is_on();
+
+	if (ft9001_cpm_hsosc_trim_get(&opp->hsosc_freq) != 0) {
+		/* Only looked at on the high-speed oscillator. */
+		opp->hsosc_freq = FT9001_CPM_OSC_FREQ_320MHZ;
+		return opp->source == FT9001_CPM_SYSCLK_OSC8M;
+	}
+
+	return true;
+}
+
+static int dfs_opp_enter(const struct ft9001_dfs_opp *opp)
+{
+	struct ft9001_cpm_clk_plan clk;
+	struct dfs_plan plan;
+
+	dfs_clk_plan_build(opp, &clk);
+	dfs_plan_build(opp, &plan);
+
+	return dfs_plan_run(opp, &clk, &plan);
+}
+
+int ft9001_dfs_level_set(enum ft9001_dfs_level level, uint32_t *latency_us)
+{
+	const struct ft9001_dfs_opp *opp = ft9001_dfs_opp_get(level);
+	struct ft9001_dfs_opp prev;
+	struct ft9001_cpm_clk_plan clk;
+	struct dfs_plan plan;
+	bool restorable;
+	uint32_t start;
+	int ret;
+
+	if (opp == NULL) {
+		return -EINVAL;
+	}
+
+	/* Refuse up front a level whose dividers do not fit their fields, or
+	 * overclock a domain on the level's source, before any step is taken.
+	 */
+	dfs_clk_plan_build(opp, &clk);
+	ret = ft9001_cpm_clk_plan_check(&clk, dfs_opp_src_hz(opp), NULL);
+	if (ret != 0) {
+		return ret;
+	}
+
+	dfs_plan_build(opp, &plan);
+	restorable = dfs_opp_capture(&prev);
+
+	start = ft9001_tick_get();
+	ret = dfs_plan_run(opp, &clk, &plan);
+
+	if (latency_us != NULL) {
+		*latency_us = ft9001_tick_us_since(start);
+	}
+
+	/* Best effort: the first error is the one reported. */
+	if (ret != 0 && restorable) {
+		(void)dfs_opp_enter(&prev);
+	}
+
+	return ret;
+}
+
+enum ft9001_dfs_level ft9001_dfs_level_get(void)
+{
+	enum ft9001_cpm_sysclk_source src = ft9001_cpm_sysclk_source_get();
+	uint32_t sys_div = ft9001_cpm_sys_div_get();
+	uint32_t ips_div = ft9001_cpm_ips_div_get();
+
+	for (uint32_t i = 0U; i < (uint32_t)FT9001_DFS_LEVEL_COUNT; i++) {
+		const struct ft9001_dfs_opp *opp = &s_opp_table[i];
+
+		if (opp->source != src || opp->sys_div != sys_div || opp->ips_div != ips_div) {
+			continue;
+		}
+		if (src == FT9001_CPM_SYSCLK_OSC400M && !dfs_trim_matches(opp->hsosc_freq)) {
+			continue;
+		}
+
+		return (enum ft9001_dfs_level)i;
+	}
+
+	return FT9001_DFS_LEVEL_COUNT;
+}
+
+uint32_t ft9001_dfs_latency_us_estimate(enum ft9001_dfs_level level)
+{
+	const struct ft9001_dfs_opp *opp = ft9001_dfs_opp_get(level);
+	struct dfs_plan plan;
+
+	if (opp == NULL) {
+		return UINT32_MAX;
+	}
+
+	dfs_plan_build(opp, &plan);
+
+	return dfs_plan_cost_us(&plan);
+}
+
+/* Let frames in flight leave at the old baud rate; a timeout only costs the
+ * tail of the FIFO, the divisor is re-derived regardless.
+ */
+static void dfs_uart_clk_changing(uint32_t changing, const uint32_t next_hz[], void *user_data)
+{
+	struct ft9001_dfs_uart *uart = user_data;
+
+	(void)changing;
+	(void)next_hz;
+
+	(void)ft9001_uart_tx_drain(uart->inst, FT9001_DFS_UART_DRAIN_MAX_US);
+}
+
+static void dfs_uart_clk_changed(uint32_t changed, void *user_data)
+{
+	struct ft9001_dfs_uart *uart = user_data;
+
+	(void)changed;
+
+	uart->err = ft9001_uart_baudrate_set(uart->inst, ft9001_cpm_ips_freq_hz_get(),
+					     uart->baudrate);
+}
+
+int ft9001_dfs_uart_register(struct ft9001_dfs_uart *uart, UART_TypeDef *inst,
+			     uint32_t baudrate)
+{
+	int ret;
+
+	/* The listener may be running off an earlier registration; leave its
+	 * fields alone.
+	 */
+	if (ft9001_cpm_clk_listener_is_registered(&uart->listener)) {
+		return -EALREADY;
+	}
+
+	uart->inst = inst;
+	uart->baudrate = baudrate;
+	uart->listener.cb = dfs_uart_clk_changed;
+	uart->listener.pre_cb = dfs_uart_clk_changing;
+	uart->listener.user_data = uart;
+	uart->listener.mask = FT9001_CPM_CLK_BIT(FT9001_CPM_CLK_IPS);
+
+	ret = ft9001_cpm_clk_listener_register(&uart->listener);
+	if (ret != 0) {
+		return ret;
+	}
+
+	dfs_uart_clk_changed(uart->listener.mask, uart);
+
+	return uart->err;
+}
+
+int ft9001_dfs_uart_unregister(struct ft9001_dfs_uart *uart)
+{
+	return ft9001_cpm_clk_listener_unregister(&uart->listener);
+}
@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2026, FocalTech Systems CO.,Ltd
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <stddef.h>
+
+#include <cmsis_core.h>
+
+#ifdef CONFIG_USE_FT9001_HAL_CACHE
+#include "ft9001_cache.h"
+#endif
+#include "ft9001_cpm.h"
+#include "ft9001_cpm_stime.h"
+#include "ft9001_irq.h"
+#include "ft9001_sleep.h"
+#include "ft9001_tick.h"
+
+static uint32_t s_sleep_keep = FT9001_SLEEP_KEEP_RTC32K | FT9001_SLEEP_KEEP_PMU128K;
+
+/* Longest prepare and finish seen per mode, in microseconds on the core tick. */
+static uint32_t s_sleep_entry_us[FT9001_SLEEP_MODE_COUNT];
+static uint32_t s_sleep_exit_us[FT9001_SLEEP_MODE_COUNT];
+
+/* Fold the time since @p start, rounded up, into a worst-case figure. */
+static void sleep_worst_update(uint32_t *worst_us, uint32_t start)
+{
+	uint32_t ticks = ft9001_tick_get() - start;
+	uint32_t us = (ticks + FT9001_TICK_PER_US - 1U) / FT9001_TICK_PER_US;
+
+	if (us > *worst_us) {
+		*worst_us = us;
+	}
+}
+
+static bool sleep_mode_is_cpm(enum ft9001_sleep_mode mode)
+{
+	return mode == FT9001_SLEEP_MODE_LOW_POWER || mode == FT9001_SLEEP_MODE_HIBERNATION;
+}
+
+void ft9001_sleep_osc_keep_set(uint32_t keep)
+{
+	s_sleep_keep = keep & FT9001_SLEEP_KEEP_ALL;
+}
+
+uint32_t ft9001_sleep_osc_keep_get(void)
+{
+	return s_sleep_keep;
+}
+
+int ft9001_sleep_latency_get(enum ft9001_sleep_mode mode, struct ft9001_sleep_latency *lat)
+{
+	if ((uint32_t)mode >= (uint32_t)FT9001_SLEEP_MODE_COUNT) {
+		return -EINVAL;
+	}
+
+	lat->entry_us = s_sleep_entry_us[mode];
+	lat->exit_us = s_sleep_exit_us[mode];
+	lat->retains_state = (mode != FT9001_SLEEP_MODE_HIBERNATION);
+
+	/* Wake-up from hibernation goes through reset, which is not timed. */
+	if (!lat->retains_state) {
+		lat->exit_us = UINT32_MAX;
+		lat->min_residency_us = UINT32_MAX;
+		return 0;
+	}
+
+	/* The wake-up waits out the high-speed oscillator's stable time when
+	 * the system clock runs from it.
+	 */
+	if (mode == FT9001_SLEEP_MODE_LOW_POWER &&
+	    ft9001_cpm_sysclk_source_get() == FT9001_CPM_SYSCLK_OSC400M) {
+		lat->exit_us += ft9001_cpm_stime_us_get(FT9001_CPM_OSC_HSOSC);
+	}
+
+	lat->min_residency_us = lat->entry_us + lat->exit_us;
+
+	return 0;
+}
+
+enum ft9001_sleep_mode ft9001_sleep_mode_select(uint32_t idle_us, uint32_t max_exit_us)
+{
+	struct ft9001_sleep_latency lat;
+
+	for (uint32_t m = (uint32_t)FT9001_SLEEP_MODE_COUNT; m-- > 0U;) {
+		enum ft9001_sleep_mode mode = (enum ft9001_sleep_mode)m;
+
+		if (ft9001_sleep_latency_get(mode, &lat) != 0 || !lat.retains_state) {
+			continue;
+		}
+
+		if (lat.min_residency_us <= idle_us && lat.exit_us <= max_exit_us) {
+			return mode;
+		}
+	}
+
+	return FT9001_SLEEP_MODE_WFI;
+}
+
+/* Hibernation powers the cache arrays down; only it needs dirty lines out. */
+static int sleep_cache_prepare(enum ft9001_sleep_mode mode)
+{
+#ifdef CONFIG_USE_FT9001_HAL_CACHE
+	bool lost = (mode == FT9001_SLEEP_MODE_HIBERNATION);
+	int ret = ft9001_cache_sleep_prepare(DCACHE, lost);
+
+	if (ret != 0) {
+		return ret;
+	}
+
+	return ft9001_cache_sleep_prepare(ICACHE, lost);
+#else
+	(void)mode;
+
+	return 0;
+#endif
+}
+
+int ft9001_sleep_prepare(enum ft9001_sleep_mode mode)
+{
+	uint32_t start = ft9001_tick_get();
+	uint32_t slpcfgr;
+	int ret;
+
+	if ((uint32_t)mode >= (uint32_t)FT9001_SLEEP_MODE_COUNT) {
+		return -EINVAL;
+	}
+
+	if (!sleep_mode_is_cpm(mode)) {
+		FT9001_CLEAR_BIT(SCB->SCR, SCB_SCR_SLEEPDEEP_Msk);
+		sleep_worst_update(&s_sleep_entry_us[mode], start);
+		return 0;
+	}
+
+	ret = sleep_cache_prepare(mode);
+	if (ret != 0) {
+		return ret;
+	}
+
+	slpcfgr = FT9001_READ_REG(CPM->SLPCFGR);
+	slpcfgr &= ~(CPM_SLPCFGR_SLEEP_MODE_Msk | FT9001_SLEEP_KEEP_ALL |
+		     CPM_SLPCFGR_HP_READY_WKPWAIT_Msk);
+	slpcfgr |= (mode == FT9001_SLEEP_MODE_LOW_POWER) ? CPM_SLPCFGR_SLEEP_MODE_LOW_POWER
+							 : CPM_SLPCFGR_SLEEP_MODE_HIBERNATION;
+	slpcfgr |= s_sleep_keep;
+
+	/* Hold the clocks on wake-up until the high-speed oscillator is back,
+	 * so the core resumes at the frequency it slept at.
+	 */
+	if (ft9001_cpm_sysclk_source_get() == FT9001_CPM_SYSCLK_OSC400M) {
+		slpcfgr |= CPM_SLPCFGR_HP_READY_WKPWAIT;
+	}
+
+	FT9001_WRITE_REG(CPM->SLPCFGR, slpcfgr);
+	FT9001_SET_BIT(SCB->SCR, SCB_SCR_SLEEPDEEP_Msk);
+
+	sleep_worst_update(&s_sleep_entry_us[mode], start);
+
+	return 0;
+}
+
+void ft9001_sleep_finish(enum ft9001_sleep_mode mode)
+{
+	uint32_t start = ft9001_tick_get();
+
+	FT9001_CLEAR_BIT(SCB->SCR, SCB_SCR_SLEEPDEEP_Msk);
+
+	if ((uint32_t)mode >= (uint32_t)FT9001_SLEEP_MODE_COUNT) {
+		return;
+	}
+
+	if (sleep_mode_is_cpm(mode)) {
+		ft9001_cpm_clk_tree_refresh();
+	}
+
+	sleep_worst_update(&s_sleep_exit_us[mode], start);
+}
+
+int ft9001_sleep_enter(enum ft9001_sleep_mode mode)
+{
+	uint32_t key = ft9001_irq_lock();
+	int ret = ft9001_sleep_prepare(mode);
+
+	if (ret == 0) {
+		__DSB();
+		__WFI();
+		__ISB();
+		ft9001_sleep_finish(mode);
+	}
+
+	ft9001_irq_unlock(key);
+
+	return ret;
+}
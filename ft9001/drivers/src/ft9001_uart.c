@@ -136,3 +136,21 @@ int ft9001_uart_configure(UART_TypeDef *inst, const struct ft9001_uart_config *c
 
 	return 0;
 }
+
+int ft9001_uart_tx_drain(UART_TypeDef *inst, uint32_t timeout_us)
+{
+	struct ft9001_deadline dl;
+	bool late;
+
+	ft9001_deadline_start(&dl, timeout_us);
+
+	for (;;) {
+		late = ft9001_deadline_expired(&dl);
+		if (ft9001_uart_tx_complete(inst)) {
+			return 0;
+		}
+		if (late) {
+			return -ETIMEDOUT;
+		}
+	}
+}
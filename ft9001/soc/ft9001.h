@@ -363,6 +363,38 @@ typedef struct {
 #define CPM_PCDIVR1_IPS_DIV_Msk             (0xFUL << CPM_PCDIVR1_IPS_DIV_Pos)
 #define CPM_PCDIVR1_IPS_DIV                 CPM_PCDIVR1_IPS_DIV_Msk
 
+/*******************  Bits definition for CPM_PCDIVR2 register  ****************/
+/* [23:20] TC_DIV[3:0] */
+#define CPM_PCDIVR2_TC_DIV_Pos              (20U)
+#define CPM_PCDIVR2_TC_DIV_Msk              (0xFUL << CPM_PCDIVR2_TC_DIV_Pos)
+#define CPM_PCDIVR2_TC_DIV                  CPM_PCDIVR2_TC_DIV_Msk
+
+/* [19:16] MESH_DIV[3:0] */
+#define CPM_PCDIVR2_MESH_DIV_Pos            (16U)
+#define CPM_PCDIVR2_MESH_DIV_Msk            (0xFUL << CPM_PCDIVR2_MESH_DIV_Pos)
+#define CPM_PCDIVR2_MESH_DIV                CPM_PCDIVR2_MESH_DIV_Msk
+
+/* [11:8] ADC_DIV[3:0] */
+#define CPM_PCDIVR2_ADC_DIV_Pos             (8U)
+#define CPM_PCDIVR2_ADC_DIV_Msk             (0xFUL << CPM_PCDIVR2_ADC_DIV_Pos)
+#define CPM_PCDIVR2_ADC_DIV                 CPM_PCDIVR2_ADC_DIV_Msk
+
+/* [3:0] MCC_DIV[3:0] */
+#define CPM_PCDIVR2_MCC_DIV_Pos             (0U)
+#define CPM_PCDIVR2_MCC_DIV_Msk             (0xFUL << CPM_PCDIVR2_MCC_DIV_Pos)
+#define CPM_PCDIVR2_MCC_DIV                 CPM_PCDIVR2_MCC_DIV_Msk
+
+/*******************  Bits definition for CPM_PCDIVR4 register  ****************/
+/* [15:8] I2S_S_DIV[7:0] */
+#define CPM_PCDIVR4_I2S_S_DIV_Pos           (8U)
+#define CPM_PCDIVR4_I2S_S_DIV_Msk           (0xFFUL << CPM_PCDIVR4_I2S_S_DIV_Pos)
+#define CPM_PCDIVR4_I2S_S_DIV               CPM_PCDIVR4_I2S_S_DIV_Msk
+
+/* [7:0] I2S_M_DIV[7:0] */
+#define CPM_PCDIVR4_I2S_M_DIV_Pos           (0U)
+#define CPM_PCDIVR4_I2S_M_DIV_Msk           (0xFFUL << CPM_PCDIVR4_I2S_M_DIV_Pos)
+#define CPM_PCDIVR4_I2S_M_DIV               CPM_PCDIVR4_I2S_M_DIV_Msk
+
 /*******************  Bits definition for CPM_CDIVUPDR register  **************/
 /* [1] SYSDIV_UPD */
 #define CPM_CDIVUPDR_SYSDIV_UPD_Pos         (1U)
@@ -560,6 +592,12 @@ typedef struct {
 #define CPM_CSWCFGR_SYS_SEL_OSC8M            (0x0UL << CPM_CSWCFGR_SYS_SEL_Pos)     /*!< 0x00000000 */
 #define CPM_CSWCFGR_SYS_SEL_OSC400M          (0x1UL << CPM_CSWCFGR_SYS_SEL_Pos)     /*!< 0x00000001 */
 
+/*******************  Bits definition for CPM_CTICKR register  ****************/
+/* [31:0] CNT: free-running OSC8M cycle count, independent of SYS_SEL */
+#define CPM_CTICKR_CNT_Pos                   (0U)
+#define CPM_CTICKR_CNT_Msk                   (0xFFFFFFFFUL << CPM_CTICKR_CNT_Pos)   /*!< 0xFFFFFFFF */
+#define CPM_CTICKR_CNT                       CPM_CTICKR_CNT_Msk
+
 /*******************  Bits definition for CPM_VCCCTMR register  *****************/
 /* [31:30] CORE_TEST_KEY[1:0] */
 #define CPM_VCCCTMR_CORE_TEST_KEY_Pos        (30U)
@@ -681,6 +719,16 @@ typedef struct {
 #define CPM_O400MTRIMR_OSC400M_TRIM_Msk      (0x1FFFFUL << CPM_O400MTRIMR_OSC400M_TRIM_Pos)
 #define CPM_O400MTRIMR_OSC400M_TRIM          CPM_O400MTRIMR_OSC400M_TRIM_Msk
 
+/****************  Bits definition for CPM_xxxSTIMER registers  ***************/
+/* OSCLSTIMER (PMU128K), OSCHSTIMER (OSC400M), OSCESTIMER (OSCEXT) and RTCSTIMER
+ * (RTC32K): time from an oscillator's enable, including its restart on
+ * wake-up, to its STABLE flag in OCSR, counted in OSC8M cycles.
+ */
+
+/* [23:0] STIME[23:0] */
+#define CPM_STIMER_STIME_Pos                (0U)
+#define CPM_STIMER_STIME_Msk                (0xFFFFFFUL << CPM_STIMER_STIME_Pos)
+#define CPM_STIMER_STIME                    CPM_STIMER_STIME_Msk
 
 /******************************************************************************/
 /*                                                                            */
@@ -912,6 +960,18 @@ typedef struct {
 #define CACHE_CCVR_DATA_Pos            (0U)
 #define CACHE_CCVR_DATA_Msk            (0xFFFFFFFFUL << CACHE_CCVR_DATA_Pos)
 #define CACHE_CCVR_DATA                CACHE_CCVR_DATA_Msk
+/* Tag accesses (CLCR.TDSEL set): [31:12] TAG, [1] MODIFIED, [0] VALID */
+#define CACHE_CCVR_TAG_Pos             (12U)
+#define CACHE_CCVR_TAG_Msk             (0xFFFFFUL << CACHE_CCVR_TAG_Pos)
+#define CACHE_CCVR_TAG                 CACHE_CCVR_TAG_Msk
+
+#define CACHE_CCVR_MODIFIED_Pos        (1U)
+#define CACHE_CCVR_MODIFIED_Msk        (0x1UL << CACHE_CCVR_MODIFIED_Pos)
+#define CACHE_CCVR_MODIFIED            CACHE_CCVR_MODIFIED_Msk
+
+#define CACHE_CCVR_VALID_Pos           (0U)
+#define CACHE_CCVR_VALID_Msk           (0x1UL << CACHE_CCVR_VALID_Pos)
+#define CACHE_CCVR_VALID               CACHE_CCVR_VALID_Msk
 
 /*******************  Bits definition for CACHE_CACR register *****************/
 /* [17] ROM_CACHEABLE */
@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2026, FocalTech Systems CO.,Ltd
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file    ft9001_boot_plan.h
+ * @brief   FT9001 boot clock and cache plan, from Kconfig.
+ *
+ * Turns the CONFIG_FT9001_BOOT_* choices into domain frequencies and packed
+ * register values, all preprocessor constants. SystemInit() applies them with
+ * plain register writes and checks them against the domain maxima at build
+ * time; with CONFIG_FT9001_CLOCK_PLAN_FIXED the CPM frequency getters return
+ * them directly while the system clock runs from the planned source.
+ *
+ * The macros only expand to CPM and cache names where they are used, so this
+ * header does not depend on ft9001_cpm.h or ft9001_cache.h.
+ */
+
+#ifndef FT9001_BOOT_PLAN_H_
+#define FT9001_BOOT_PLAN_H_
+
+#include "ft9001.h"
+
+#if defined(CONFIG_FT9001_BOOT_SYSCLK_HSOSC_400MHZ)
+#define FT9001_BOOT_HSOSC_FREQ FT9001_CPM_OSC_FREQ_400MHZ
+#define FT9001_BOOT_SYSCLK     FT9001_CPM_SYSCLK_OSC400M
+#define FT9001_BOOT_SRC_HZ     (400000000UL)
+#elif defined(CONFIG_FT9001_BOOT_SYSCLK_HSOSC_320MHZ)
+#define FT9001_BOOT_HSOSC_FREQ FT9001_CPM_OSC_FREQ_320MHZ
+#define FT9001_BOOT_SYSCLK     FT9001_CPM_SYSCLK_OSC400M
+#define FT9001_BOOT_SRC_HZ     (320000000UL)
+#else
+/* OSC8M; FT9001_BOOT_HSOSC_FREQ stays undefined. */
+#define FT9001_BOOT_SYSCLK FT9001_CPM_SYSCLK_OSC8M
+#define FT9001_BOOT_SRC_HZ (8000000UL)
+#endif
+
+/* Domain frequencies, following the divider chain of the clock-tree model. */
+#define FT9001_BOOT_SYS_HZ   (FT9001_BOOT_SRC_HZ / (CONFIG_FT9001_BOOT_SYS_DIV + 1UL))
+#define FT9001_BOOT_IPS_HZ   (FT9001_BOOT_SYS_HZ / (CONFIG_FT9001_BOOT_IPS_DIV + 1UL))
+#define FT9001_BOOT_AHB3_HZ  (FT9001_BOOT_SYS_HZ / (CONFIG_FT9001_BOOT_AHB3_DIV + 1UL))
+#define FT9001_BOOT_ARITH_HZ (FT9001_BOOT_SYS_HZ / (CONFIG_FT9001_BOOT_ARITH_DIV + 1UL))
+#define FT9001_BOOT_TRACE_HZ (FT9001_BOOT_SYS_HZ / (CONFIG_FT9001_BOOT_TRACE_DIV + 1UL))
+#define FT9001_BOOT_I2S_M_HZ (FT9001_BOOT_SYS_HZ / (CONFIG_FT9001_BOOT_I2S_M_DIV + 1UL))
+#define FT9001_BOOT_I2S_S_HZ (FT9001_BOOT_SYS_HZ / (CONFIG_FT9001_BOOT_I2S_S_DIV + 1UL))
+#define FT9001_BOOT_TC_HZ    (FT9001_BOOT_IPS_HZ / (CONFIG_FT9001_BOOT_TC_DIV + 1UL))
+#define FT9001_BOOT_ADC_HZ   (FT9001_BOOT_IPS_HZ / (CONFIG_FT9001_BOOT_ADC_DIV + 1UL))
+#define FT9001_BOOT_MCC_HZ   (FT9001_BOOT_IPS_HZ / (CONFIG_FT9001_BOOT_MCC_DIV + 1UL))
+#define FT9001_BOOT_MESH_HZ  (FT9001_BOOT_IPS_HZ / (CONFIG_FT9001_BOOT_MESH_DIV + 1UL))
+
+/* Cache policy per instance and region, from one Kconfig choice each. */
+#if defined(CONFIG_FT9001_BOOT_ICACHE_BOOT_WB)
+#define FT9001_BOOT_ICACHE_BOOT FT9001_CACHE_MODE_WRITE_BACK
+#elif defined(CONFIG_FT9001_BOOT_ICACHE_BOOT_WT)
+#define FT9001_BOOT_ICACHE_BOOT FT9001_CACHE_MODE_WRITE_THROUGH
+#else
+#define FT9001_BOOT_ICACHE_BOOT FT9001_CACHE_MODE_OFF
+#endif
+
+#if defined(CONFIG_FT9001_BOOT_ICACHE_ROM_WB)
+#define FT9001_BOOT_ICACHE_ROM FT9001_CACHE_MODE_WRITE_BACK
+#elif defined(CONFIG_FT9001_BOOT_ICACHE_ROM_WT)
+#define FT9001_BOOT_ICACHE_ROM FT9001_CACHE_MODE_WRITE_THROUGH
+#else
+#define FT9001_BOOT_ICACHE_ROM FT9001_CACHE_MODE_OFF
+#endif
+
+#if defined(CONFIG_FT9001_BOOT_ICACHE_SPIM1_WB)
+#define FT9001_BOOT_ICACHE_SPIM1 FT9001_CACHE_MODE_WRITE_BACK
+#elif defined(CONFIG_FT9001_BOOT_ICACHE_SPIM1_WT)
+#define FT9001_BOOT_ICACHE_SPIM1 FT9001_CACHE_MODE_WRITE_THROUGH
+#else
+#define FT9001_BOOT_ICACHE_SPIM1 FT9001_CACHE_MODE_OFF
+#endif
+
+#if defined(CONFIG_FT9001_BOOT_ICACHE_SPIM2_WB)
+#define FT9001_BOOT_ICACHE_SPIM2 FT9001_CACHE_MODE_WRITE_BACK
+#elif defined(CONFIG_FT9001_BOOT_ICACHE_SPIM2_WT)
+#define FT9001_BOOT_ICACHE_SPIM2 FT9001_CACHE_MODE_WRITE_THROUGH
+#else
+#define FT9001_BOOT_ICACHE_SPIM2 FT9001_CACHE_MODE_OFF
+#endif
+
+#if defined(CONFIG_FT9001_BOOT_ICACHE_SPIM3_WB)
+#define FT9001_BOOT_ICACHE_SPIM3 FT9001_CACHE_MODE_WRITE_BACK
+#elif defined(CONFIG_FT9001_BOOT_ICACHE_SPIM3_WT)
+#define FT9001_BOOT_ICACHE_SPIM3 FT9001_CACHE_MODE_WRITE_THROUGH
+#else
+#define FT9001_BOOT_ICACHE_SPIM3 FT9001_CACHE_MODE_OFF
+#endif
+
+#if defined(CONFIG_FT9001_BOOT_DCACHE_BOOT_WB)
+#define FT9001_BOOT_DCACHE_BOOT FT9001_CACHE_MODE_WRITE_BACK
+#elif defined(CONFIG_FT9001_BOOT_DCACHE_BOOT_WT)
+#define FT9001_BOOT_DCACHE_BOOT FT9001_CACHE_MODE_WRITE_THROUGH
+#else
+#define FT9001_BOOT_DCACHE_BOOT FT9001_CACHE_MODE_OFF
+#endif
+
+#if defined(CONFIG_FT9001_BOOT_DCACHE_ROM_WB)
+#define FT9001_BOOT_DCACHE_ROM FT9001_CACHE_MODE_WRITE_BACK
+#elif defined(CONFIG_FT9001_BOOT_DCACHE_ROM_WT)
+#define FT9001_BOOT_DCACHE_ROM FT9001_CACHE_MODE_WRITE_THROUGH
+#else
+#define FT9001_BOOT_DCACHE_ROM FT9001_CACHE_MODE_OFF
+#endif
+
+#if defined(CONFIG_FT9001_BOOT_DCACHE_SPIM1_WB)
+#define FT9001_BOOT_DCACHE_SPIM1 FT9001_CACHE_MODE_WRITE_BACK
+#elif defined(CONFIG_FT9001_BOOT_DCACHE_SPIM1_WT)
+#define FT9001_BOOT_DCACHE_SPIM1 FT9001_CACHE_MODE_WRITE_THROUGH
+#else
+#define FT9001_BOOT_DCACHE_SPIM1 FT9001_CACHE_MODE_OFF
+#endif
+
+#if defined(CONFIG_FT9001_BOOT_DCACHE_SPIM2_WB)
+#define FT9001_BOOT_DCACHE_SPIM2 FT9001_CACHE_MODE_WRITE_BACK
+#elif defined(CONFIG_FT9001_BOOT_DCACHE_SPIM2_WT)
+#define FT9001_BOOT_DCACHE_SPIM2 FT9001_CACHE_MODE_WRITE_THROUGH
+#else
+#define FT9001_BOOT_DCACHE_SPIM2 FT9001_CACHE_MODE_OFF
+#endif
+
+#if defined(CONFIG_FT9001_BOOT_DCACHE_SPIM3_WB)
+#define FT9001_BOOT_DCACHE_SPIM3 FT9001_CACHE_MODE_WRITE_BACK
+#elif defined(CONFIG_FT9001_BOOT_DCACHE_SPIM3_WT)
+#define FT9001_BOOT_DCACHE_SPIM3 FT9001_CACHE_MODE_WRITE_THROUGH
+#else
+#define FT9001_BOOT_DCACHE_SPIM3 FT9001_CACHE_MODE_OFF
+#endif
+
+/** @brief Initializer for the struct ft9001_cpm_clk_regs of the boot plan. */
+#define FT9001_BOOT_CLK_REGS_INIT                                                          \
+	{                                                                                  \
+		.scdivr = CPM_SCDIVR_SYS_DIV_VAL(CONFIG_FT9001_BOOT_SYS_DIV) |             \
+			  CPM_SCDIVR_TRACE_DIV_VAL(CONFIG_FT9001_BOOT_TRACE_DIV),          \
+		.pcdivr1 = ((uint32_t)CONFIG_FT9001_BOOT_AHB3_DIV << CPM_PCDIVR1_AHB3_DIV_Pos) | \
+			   ((uint32_t)CONFIG_FT9001_BOOT_ARITH_DIV                         \
+			    << CPM_PCDIVR1_ARITH_DIV_Pos) |                                \
+			   ((uint32_t)CONFIG_FT9001_BOOT_IPS_DIV << CPM_PCDIVR1_IPS_DIV_Pos), \
+		.pcdivr2 = ((uint32_t)CONFIG_FT9001_BOOT_TC_DIV << CPM_PCDIVR2_TC_DIV_Pos) | \
+			   ((uint32_t)CONFIG_FT9001_BOOT_MESH_DIV                          \
+			    << CPM_PCDIVR2_MESH_DIV_Pos) |                                 \
+			   ((uint32_t)CONFIG_FT9001_BOOT_ADC_DIV << CPM_PCDIVR2_ADC_DIV_Pos) | \
+			   ((uint32_t)CONFIG_FT9001_BOOT_MCC_DIV << CPM_PCDIVR2_MCC_DIV_Pos), \
+		.pcdivr4 = ((uint32_t)CONFIG_FT9001_BOOT_I2S_S_DIV                         \
+			    << CPM_PCDIVR4_I2S_S_DIV_Pos) |                                \
+			   ((uint32_t)CONFIG_FT9001_BOOT_I2S_M_DIV                         \
+			    << CPM_PCDIVR4_I2S_M_DIV_Pos),                                 \
+	}
+
+/** @brief Initializer for the struct ft9001_cache_regs of the I-cache. */
+#define FT9001_BOOT_ICACHE_REGS_INIT                                                       \
+	{                                                                                  \
+		.csacr = FT9001_CACHE_CSACR_VAL(FT9001_BOOT_ICACHE_BOOT,                   \
+						FT9001_BOOT_ICACHE_SPIM1,                  \
+						FT9001_BOOT_ICACHE_SPIM2,                  \
+						FT9001_BOOT_ICACHE_SPIM3),                 \
+		.cacr_rom = FT9001_CACHE_CACR_ROM_VAL(FT9001_BOOT_ICACHE_ROM),             \
+	}
+
+/** @brief Initializer for the struct ft9001_cache_regs of the D-cache. */
+#define FT9001_BOOT_DCACHE_REGS_INIT                                                       \
+	{                                                                                  \
+		.csacr = FT9001_CACHE_CSACR_VAL(FT9001_BOOT_DCACHE_BOOT,                   \
+						FT9001_BOOT_DCACHE_SPIM1,                  \
+						FT9001_BOOT_DCACHE_SPIM2,                  \
+						FT9001_BOOT_DCACHE_SPIM3),                 \
+		.cacr_rom = FT9001_CACHE_CACR_ROM_VAL(FT9001_BOOT_DCACHE_ROM),             \
+	}
+
+#endif /* FT9001_BOOT_PLAN_H_ */
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2026, FocalTech Systems CO.,Ltd
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/pm/pm.h>
+#include <zephyr/pm/policy.h>
+
+#include "ft9001_sleep.h"
+
+/* Sleep mode behind each Zephyr power state, or FT9001_SLEEP_MODE_COUNT. */
+static enum ft9001_sleep_mode pm_sleep_mode(enum pm_state state)
+{
+	switch (state) {
+	case PM_STATE_RUNTIME_IDLE:
+		return FT9001_SLEEP_MODE_WFI;
+	case PM_STATE_SUSPEND_TO_IDLE:
+		return FT9001_SLEEP_MODE_LOW_POWER;
+	case PM_STATE_SOFT_OFF:
+		return FT9001_SLEEP_MODE_HIBERNATION;
+	default:
+		return FT9001_SLEEP_MODE_COUNT;
+	}
+}
+
+void pm_state_set(enum pm_state state, uint8_t substate_id)
+{
+	enum ft9001_sleep_mode mode = pm_sleep_mode(state);
+
+	ARG_UNUSED(substate_id);
+
+	if (ft9001_sleep_prepare(mode) != 0) {
+		return;
+	}
+
+	k_cpu_idle();
+
+	ft9001_sleep_finish(mode);
+}
+
+void pm_state_exit_post_ops(enum pm_state state, uint8_t substate_id)
+{
+	ARG_UNUSED(state);
+	ARG_UNUSED(substate_id);
+
+	/* The PM core enters with interrupts locked and expects them released. */
+	irq_unlock(0);
+}
+
+#ifdef CONFIG_PM_POLICY_CUSTOM
+const struct pm_state_info *pm_policy_next_state(uint8_t cpu, int32_t ticks)
+{
+	static struct pm_state_info info = {
+		.state = PM_STATE_SUSPEND_TO_IDLE,
+	};
+	struct ft9001_sleep_latency lat;
+	uint32_t idle_us;
+
+	ARG_UNUSED(cpu);
+
+	if (ticks == K_TICKS_FOREVER) {
+		idle_us = UINT32_MAX;
+	} else {
+		idle_us = k_ticks_to_us_floor32((uint32_t)ticks);
+	}
+
+	if (ft9001_sleep_mode_select(idle_us, UINT32_MAX) != FT9001_SLEEP_MODE_LOW_POWER ||
+	    pm_policy_state_lock_is_active(PM_STATE_SUSPEND_TO_IDLE, PM_ALL_SUBSTATES)) {
+		return NULL;
+	}
+
+	(void)ft9001_sleep_latency_get(FT9001_SLEEP_MODE_LOW_POWER, &lat);
+	info.min_residency_us = lat.min_residency_us;
+	info.exit_latency_us = lat.exit_us;
+
+	return &info;
+}
+#endif /* CONFIG_PM_POLICY_CUSTOM */
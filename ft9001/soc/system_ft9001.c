@@ -5,46 +5,92 @@
  */
 
 #include "ft9001_hal.h"
+#include "ft9001_boot_plan.h"
 #include "system_ft9001.h"
 
-/* Budget for the OSC400M switch. Each poll is a single register read issued at
- * OSC8M, so this bounds the wait without depending on a wall-clock estimate.
+/* Timeout for the boot source switch, covering the oscillator's start-up and
+ * the programmed stable time with a wide margin.
  */
-#define SYSCLK_SWITCH_POLLS (100000UL)
+#define SYSCLK_SWITCH_TIMEOUT_US (50000U)
 
-uint32_t SystemCoreClock = 160000000U;
+/* Kconfig keeps the fields in range, but the boot plan can also be built
+ * outside Kconfig; the packed registers must not spill into the neighbours.
+ */
+_Static_assert(CONFIG_FT9001_BOOT_SYS_DIV <= 0xFF, "boot SYS divider too wide");
+_Static_assert(CONFIG_FT9001_BOOT_TRACE_DIV <= 0xFF, "boot TRACE divider too wide");
+_Static_assert(CONFIG_FT9001_BOOT_AHB3_DIV <= 0xF, "boot AHB3 divider too wide");
+_Static_assert(CONFIG_FT9001_BOOT_ARITH_DIV <= 0xF, "boot ARITH divider too wide");
+_Static_assert(CONFIG_FT9001_BOOT_IPS_DIV <= 0xF, "boot IPS divider too wide");
+_Static_assert(CONFIG_FT9001_BOOT_TC_DIV <= 0xF, "boot TC divider too wide");
+_Static_assert(CONFIG_FT9001_BOOT_ADC_DIV <= 0xF, "boot ADC divider too wide");
+_Static_assert(CONFIG_FT9001_BOOT_MCC_DIV <= 0xF, "boot MCC divider too wide");
+_Static_assert(CONFIG_FT9001_BOOT_MESH_DIV <= 0xF, "boot MESH divider too wide");
+_Static_assert(CONFIG_FT9001_BOOT_I2S_M_DIV <= 0xFF, "boot I2S_M divider too wide");
+_Static_assert(CONFIG_FT9001_BOOT_I2S_S_DIV <= 0xFF, "boot I2S_S divider too wide");
+
+/* Every domain of the boot plan against the maximum of the clock it divides
+ * down, the same limits ft9001_cpm_clk_plan_check() applies at run time.
+ */
+_Static_assert(FT9001_BOOT_SYS_HZ <= FT9001_CPM_SYS_MAX_HZ, "boot SYS clock above maximum");
+_Static_assert(FT9001_BOOT_AHB3_HZ <= FT9001_CPM_SYS_MAX_HZ, "boot AHB3 clock above maximum");
+_Static_assert(FT9001_BOOT_ARITH_HZ <= FT9001_CPM_SYS_MAX_HZ, "boot ARITH clock above maximum");
+_Static_assert(FT9001_BOOT_TRACE_HZ <= FT9001_CPM_SYS_MAX_HZ, "boot TRACE clock above maximum");
+_Static_assert(FT9001_BOOT_I2S_M_HZ <= FT9001_CPM_SYS_MAX_HZ, "boot I2S_M clock above maximum");
+_Static_assert(FT9001_BOOT_I2S_S_HZ <= FT9001_CPM_SYS_MAX_HZ, "boot I2S_S clock above maximum");
+_Static_assert(FT9001_BOOT_IPS_HZ <= FT9001_CPM_IPS_MAX_HZ, "boot IPS clock above maximum");
+_Static_assert(FT9001_BOOT_TC_HZ <= FT9001_CPM_IPS_MAX_HZ, "boot TC clock above maximum");
+_Static_assert(FT9001_BOOT_ADC_HZ <= FT9001_CPM_IPS_MAX_HZ, "boot ADC clock above maximum");
+_Static_assert(FT9001_BOOT_MCC_HZ <= FT9001_CPM_IPS_MAX_HZ, "boot MCC clock above maximum");
+_Static_assert(FT9001_BOOT_MESH_HZ <= FT9001_CPM_IPS_MAX_HZ, "boot MESH clock above maximum");
+
+/* OSC8M, what the core runs from out of reset. SystemInit() leaves the clock
+ * wherever the trim and the switch actually got it, and the CPM setters it
+ * goes through update this to match.
+ */
+uint32_t SystemCoreClock = 8000000UL;
 
 void SystemInit(void)
 {
-	static const struct ft9001_cache_config icache_cfg = {
-		.boot = FT9001_CACHE_MODE_OFF,
-		.rom = FT9001_CACHE_MODE_WRITE_BACK,
-		.spim1 = FT9001_CACHE_MODE_WRITE_BACK,
-		.spim2 = FT9001_CACHE_MODE_WRITE_BACK,
-		.spim3 = FT9001_CACHE_MODE_WRITE_BACK,
-	};
-	static const struct ft9001_cache_config dcache_cfg = {
-		.boot = FT9001_CACHE_MODE_OFF,
-		.rom = FT9001_CACHE_MODE_OFF,
-		.spim1 = FT9001_CACHE_MODE_WRITE_BACK,
-		.spim2 = FT9001_CACHE_MODE_WRITE_BACK,
-		.spim3 = FT9001_CACHE_MODE_WRITE_BACK,
-	};
+	static const struct ft9001_cpm_clk_regs clk_regs = FT9001_BOOT_CLK_REGS_INIT;
+	static const struct ft9001_cache_regs icache_regs = FT9001_BOOT_ICACHE_REGS_INIT;
+	static const struct ft9001_cache_regs dcache_regs = FT9001_BOOT_DCACHE_REGS_INIT;
+
+	struct ft9001_cpm_switch sw = {0};
+	bool switching = false;
 
 	ft9001_wdt_disable(WDT);
 
+	/* Every divider goes in while still on OSC8M, so no domain runs above
+	 * its rating once the high-speed oscillator takes over.
+	 */
+	(void)ft9001_cpm_clk_regs_write(&clk_regs);
+
+#ifdef FT9001_BOOT_HSOSC_FREQ
+	/* Let the high-speed oscillator stabilise while the rest of the boot
+	 * configuration runs at OSC8M; commit the switch at the end.
+	 */
+	if (ft9001_cpm_hsosc_trim_set(FT9001_BOOT_HSOSC_FREQ) == 0 &&
+	    ft9001_cpm_sysclk_switch_start(&sw, FT9001_CPM_SYSCLK_OSC400M,
+					   SYSCLK_SWITCH_TIMEOUT_US) == 0) {
+		switching = true;
+	}
+#endif
+
 	/* One-shot by default; this does not start the counter. */
 	ft9001_tc_mode_set(TC, FT9001_TC_MODE_ONE_SHOT);
 
-	(void)ft9001_cpm_hsosc_trim_set(FT9001_CPM_OSC_FREQ_320MHZ);
-	(void)ft9001_cpm_sysclk_source_set(FT9001_CPM_SYSCLK_OSC400M, SYSCLK_SWITCH_POLLS);
-	(void)ft9001_cpm_ips_div_set(1U);
+	(void)ft9001_cache_init_regs(ICACHE, &icache_regs);
+	(void)ft9001_cache_init_regs(DCACHE, &dcache_regs);
 
-	ft9001_cache_init(ICACHE, &icache_cfg);
-	ft9001_cache_init(DCACHE, &dcache_cfg);
+	if (switching) {
+		(void)ft9001_cpm_sysclk_switch_complete(&sw);
+	}
 }
 
+/* The CPM setters keep SystemCoreClock current; this only matters after the
+ * CPM registers were written behind the HAL's back.
+ */
 void SystemCoreClockUpdate(void)
 {
-	SystemCoreClock = ft9001_cpm_sysclk_freq_hz_get();
+	ft9001_cpm_clk_tree_refresh();
 }
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2026, FocalTech Systems CO.,Ltd
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file    host_test.h
+ * @brief   Host harness: peripheral blocks in RAM and a minimal check macro.
+ *
+ * Include this first, then the driver sources under test. The peripheral
+ * macros of ft9001.h are pointed at zeroed RAM images the test can read and
+ * write, and ft9001_irq.h is replaced by host versions that mask nothing.
+ * Registers only hold what was written to them, so a test sets status bits
+ * itself and never runs a wait that depends on the hardware moving.
+ */
+
+#ifndef HOST_TEST_H_
+#define HOST_TEST_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "ft9001.h"
+
+static CPM_TypeDef host_cpm;
+static WDT_TypeDef host_wdt;
+static TC_TypeDef host_tc;
+static CACHE_TypeDef host_icache;
+static CACHE_TypeDef host_dcache;
+static UART_TypeDef host_uart2;
+static UART_TypeDef host_uart3;
+
+#undef CPM
+#undef WDT
+#undef TC
+#undef ICACHE
+#undef DCACHE
+#undef UART2
+#undef UART3
+#define CPM    (&host_cpm)
+#define WDT    (&host_wdt)
+#define TC     (&host_tc)
+#define ICACHE (&host_icache)
+#define DCACHE (&host_dcache)
+#define UART2  (&host_uart2)
+#define UART3  (&host_uart3)
+
+/* Host ft9001_irq.h: one thread, nothing to mask. */
+#define FT9001_IRQ_H_
+
+static inline uint32_t ft9001_irq_lock(void)
+{
+	return 0U;
+}
+
+static inline void ft9001_irq_unlock(uint32_t key)
+{
+	(void)key;
+}
+
+static inline void ft9001_irq_reg_modify(volatile uint32_t *reg, uint32_t clear, uint32_t set)
+{
+	*reg = (*reg & ~clear) | set;
+}
+
+static inline void ft9001_irq_reg_set(volatile uint32_t *reg, uint32_t bits)
+{
+	ft9001_irq_reg_modify(reg, 0U, bits);
+}
+
+static inline void ft9001_irq_reg_clear(volatile uint32_t *reg, uint32_t bits)
+{
+	ft9001_irq_reg_modify(reg, bits, 0U);
+}
+
+static int host_failures;
+
+/** @brief Record a failure, with its location, when @p a != @p b. */
+#define CHECK_EQ(a, b)                                                                     \
+	do {                                                                               \
+		unsigned long long a_ = (unsigned long long)(a);                           \
+		unsigned long long b_ = (unsigned long long)(b);                           \
+		if (a_ != b_) {                                                            \
+			fprintf(stderr, "%s:%d: %s == %llu, expected %s == %llu\n",        \
+				__FILE__, __LINE__, #a, a_, #b, b_);                       \
+			host_failures++;                                                   \
+		}                                                                          \
+	} while (0)
+
+/** @brief Record a failure, with its location, when @p cond is false. */
+#define CHECK(cond) CHECK_EQ(!!(cond), 1)
+
+/** @brief Exit status of the test. */
+#define HOST_TEST_RESULT() ((host_failures == 0) ? 0 : 1)
+
+#endif /* HOST_TEST_H_ */
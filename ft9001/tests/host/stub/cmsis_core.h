@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2026, FocalTech Systems CO.,Ltd
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Host stand-in for the CMSIS core header: the barriers and WFI do nothing. */
+
+#ifndef HOST_CMSIS_CORE_H_
+#define HOST_CMSIS_CORE_H_
+
+#include <stdint.h>
+
+static inline void __DSB(void)
+{
+}
+
+static inline void __ISB(void)
+{
+}
+
+static inline void __WFI(void)
+{
+}
+
+#endif /* HOST_CMSIS_CORE_H_ */
@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2026, FocalTech Systems CO.,Ltd
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Line rounding and page splitting of the asynchronous range invalidate in
+ * ft9001_cache.c. The test plays the engine: it clears CPES.START_INVAL to
+ * finish each page.
+ */
+
+#include "host_test.h"
+
+#include "ft9001_cache.c"
+
+static void cache_reset(void)
+{
+	host_dcache = (CACHE_TypeDef){0};
+	host_dcache.CACHE_CCR = CACHE_CCR_ENCACHE;
+	host_dcache.CACHE_CCG = CACHE_CCG_CLK_ENABLE;
+	ft9001_cache_inval_global_min_set(UINT32_MAX);
+}
+
+/* Finish the page in flight and return what the next poll issued. */
+static int page_done(struct ft9001_cache_op *op)
+{
+	host_dcache.CACHE_CPES &= ~CACHE_CPES_START_INVAL;
+	return ft9001_cache_op_poll(op);
+}
+
+static void check_page(uint32_t base, uint32_t len)
+{
+	CHECK_EQ(host_dcache.CACHE_CPEA, base);
+	CHECK_EQ(host_dcache.CACHE_CPES, len | CACHE_CPES_START_INVAL);
+}
+
+static void test_line_rounding(void)
+{
+	struct ft9001_cache_op op;
+
+	cache_reset();
+
+	/* Two bytes straddling a line boundary cover both lines. */
+	CHECK_EQ(ft9001_cache_invalidate_range_start(&op, DCACHE, 0x1000000FUL, 2U, 100U), 0);
+	check_page(0x10000000UL, 2U * FT9001_CACHE_LINE_SIZE);
+	CHECK_EQ(op.left, 0U);
+	CHECK_EQ(ft9001_cache_op_poll(&op), -EINPROGRESS);
+	CHECK_EQ(page_done(&op), 0);
+	CHECK(op.done);
+
+	/* An aligned, whole line stays one line. */
+	CHECK_EQ(ft9001_cache_invalidate_range_start(&op, DCACHE, 0x10000020UL,
+						     FT9001_CACHE_LINE_SIZE, 100U),
+		 0);
+	check_page(0x10000020UL, FT9001_CACHE_LINE_SIZE);
+	CHECK_EQ(page_done(&op), 0);
+}
+
+static void test_page_split(void)
+{
+	struct ft9001_cache_op op;
+	uint32_t base = 0x10000000UL;
+	uint32_t len = 0x20010UL;
+
+	cache_reset();
+
+	/* 0x20000 bytes from a misaligned start: 0x20010 after rounding, more
+	 * than two of the largest pages.
+	 */
+	CHECK_EQ(ft9001_cache_invalidate_range_start(&op, DCACHE, base + 7U, 0x20000UL, 100U), 0);
+	check_page(base, CACHE_PAGE_MAX);
+	CHECK_EQ(op.left, len - CACHE_PAGE_MAX);
+
+	/* The next page waits for the engine. */
+	CHECK_EQ(ft9001_cache_op_poll(&op), -EINPROGRESS);
+	check_page(base, CACHE_PAGE_MAX);
+
+	CHECK_EQ(page_done(&op), -EINPROGRESS);
+	check_page(base + CACHE_PAGE_MAX, CACHE_PAGE_MAX);
+
+	CHECK_EQ(page_done(&op), -EINPROGRESS);
+	check_page(base + 2U * CACHE_PAGE_MAX, len - 2U * CACHE_PAGE_MAX);
+	CHECK_EQ(op.left, 0U);
+
+	CHECK_EQ(page_done(&op), 0);
+	CHECK(op.done);
+	CHECK_EQ(ft9001_cache_op_poll(&op), 0);
+}
+
+static void test_skips(void)
+{
+	struct ft9001_cache_op op;
+
+	/* Nothing to do for an empty range. */
+	cache_reset();
+	CHECK_EQ(ft9001_cache_invalidate_range_start(&op, DCACHE, 0x10000000UL, 0U, 100U), 0);
+	CHECK(op.done);
+	CHECK_EQ(host_dcache.CACHE_CPES, 0U);
+
+	/* Nor for a disabled or gated cache. */
+	host_dcache.CACHE_CCR = 0U;
+	CHECK_EQ(ft9001_cache_invalidate_range_start(&op, DCACHE, 0x10000000UL, 64U, 100U), 0);
+	CHECK(op.done);
+	CHECK_EQ(host_dcache.CACHE_CPES, 0U);
+
+	cache_reset();
+	host_dcache.CACHE_CCG = 0U;
+	CHECK_EQ(ft9001_cache_invalidate_range_start(&op, DCACHE, 0x10000000UL, 64U, 100U), 0);
+	CHECK(op.done);
+	CHECK_EQ(host_dcache.CACHE_CPES, 0U);
+
+	/* A page still in flight refuses a new operation. */
+	cache_reset();
+	host_dcache.CACHE_CPES = CACHE_CPES_START_INVAL;
+	CHECK_EQ(ft9001_cache_invalidate_range_start(&op, DCACHE, 0x10000000UL, 64U, 100U),
+		 -EBUSY);
+}
+
+static void test_global_shortcut(void)
+{
+	struct ft9001_cache_op op;
+
+	/* At the threshold, and with no write-back region, one global command
+	 * replaces the pages.
+	 */
+	cache_reset();
+	ft9001_cache_inval_global_min_set(4096U);
+	CHECK_EQ(ft9001_cache_invalidate_range_start(&op, DCACHE, 0x10000000UL, 4096U, 100U), 0);
+	CHECK_EQ(host_dcache.CACHE_CPES, 0U);
+	CHECK_EQ(host_dcache.CACHE_CCR & (CACHE_CCR_CMD_MSK | CACHE_CCR_GO),
+		 CACHE_CCR_INVW1 | CACHE_CCR_INVW0 | CACHE_CCR_GO);
+	CHECK_EQ(op.left, 0U);
+
+	/* Below it, pages. */
+	cache_reset();
+	ft9001_cache_inval_global_min_set(4096U);
+	CHECK_EQ(ft9001_cache_invalidate_range_start(&op, DCACHE, 0x10000000UL, 4080U, 100U), 0);
+	check_page(0x10000000UL, 4080U);
+
+	/* A write-back region could lose dirty lines to a global invalidate. */
+	cache_reset();
+	ft9001_cache_inval_global_min_set(4096U);
+	host_dcache.CACHE_CSACR = FT9001_CACHE_CSACR_MODE(FT9001_CACHE_MODE_WRITE_BACK);
+	CHECK_EQ(ft9001_cache_invalidate_range_start(&op, DCACHE, 0x10000000UL, 4096U, 100U), 0);
+	check_page(0x10000000UL, 4096U);
+	CHECK_EQ(host_dcache.CACHE_CCR & CACHE_CCR_GO, 0U);
+}
+
+int main(void)
+{
+	test_line_rounding();
+	test_page_split();
+	test_skips();
+	test_global_shortcut();
+
+	return HOST_TEST_RESULT();
+}
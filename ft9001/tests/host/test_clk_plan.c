@@ -0,0 +1,270 @@
+/*
+ * Copyright (c) 2026, FocalTech Systems CO.,Ltd
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Clock plan packing, read-back, prediction and checks in ft9001_cpm.c. */
+
+#include "host_test.h"
+
+#include "ft9001_cpm.c"
+
+static const struct ft9001_cpm_clk_plan s_plan = {
+	.sys_div = 1U,
+	.trace_div = 0xA5U,
+	.ahb3_div = 1U,
+	.arith_div = 2U,
+	.ips_div = 3U,
+	.tc_div = 4U,
+	.adc_div = 5U,
+	.mcc_div = 6U,
+	.mesh_div = 7U,
+	.i2s_m_div = 0x81U,
+	.i2s_s_div = 0xFFU,
+};
+
+struct notify_log {
+	uint32_t pre_calls;
+	uint32_t changing;
+	uint32_t next_ips_hz;
+	uint32_t model_ips_hz_at_pre;
+	uint32_t calls;
+	uint32_t changed;
+};
+
+static void log_pre(uint32_t changing, const uint32_t next_hz[FT9001_CPM_CLK_COUNT],
+		    void *user_data)
+{
+	struct notify_log *log = user_data;
+
+	log->pre_calls++;
+	log->changing = changing;
+	log->next_ips_hz = next_hz[FT9001_CPM_CLK_IPS];
+	log->model_ips_hz_at_pre = ft9001_cpm_ips_freq_hz_get();
+}
+
+static void log_post(uint32_t changed, void *user_data)
+{
+	struct notify_log *log = user_data;
+
+	log->calls++;
+	log->changed = changed;
+}
+
+static void cpm_reset(uint32_t sys_sel)
+{
+	host_cpm = (CPM_TypeDef){0};
+	host_cpm.CSWCFGR = sys_sel;
+	s_clk_tree_valid = false;
+}
+
+static void plan_equal(const struct ft9001_cpm_clk_plan *a, const struct ft9001_cpm_clk_plan *b)
+{
+	CHECK_EQ(a->sys_div, b->sys_div);
+	CHECK_EQ(a->trace_div, b->trace_div);
+	CHECK_EQ(a->ahb3_div, b->ahb3_div);
+	CHECK_EQ(a->arith_div, b->arith_div);
+	CHECK_EQ(a->ips_div, b->ips_div);
+	CHECK_EQ(a->tc_div, b->tc_div);
+	CHECK_EQ(a->adc_div, b->adc_div);
+	CHECK_EQ(a->mcc_div, b->mcc_div);
+	CHECK_EQ(a->mesh_div, b->mesh_div);
+	CHECK_EQ(a->i2s_m_div, b->i2s_m_div);
+	CHECK_EQ(a->i2s_s_div, b->i2s_s_div);
+}
+
+static void test_apply_round_trip(void)
+{
+	struct ft9001_cpm_clk_plan back;
+
+	cpm_reset(CPM_CSWCFGR_SYS_SEL_OSC400M);
+	/* CLKOUT_DIV shares SCDIVR and must survive the plan. */
+	host_cpm.SCDIVR = CPM_SCDIVR_CLKOUT_DIV_Msk;
+
+	CHECK_EQ(ft9001_cpm_clk_plan_apply(&s_plan), 0);
+
+	CHECK_EQ(host_cpm.CDIVENR & CPM_PLAN_DIVEN, CPM_PLAN_DIVEN);
+	CHECK_EQ(host_cpm.CDIVUPDR, CPM_CDIVUPDR_SYSDIV_UPD | CPM_CDIVUPDR_PERDIV_UPD);
+	CHECK_EQ(host_cpm.SCDIVR & CPM_SCDIVR_CLKOUT_DIV_Msk, CPM_SCDIVR_CLKOUT_DIV_Msk);
+
+	ft9001_cpm_clk_plan_get(&back);
+	plan_equal(&back, &s_plan);
+}
+
+static void test_regs_round_trip(void)
+{
+	struct ft9001_cpm_clk_regs regs;
+	struct ft9001_cpm_clk_plan back;
+
+	cpm_reset(CPM_CSWCFGR_SYS_SEL_OSC400M);
+	CHECK_EQ(ft9001_cpm_clk_plan_apply(&s_plan), 0);
+
+	/* Pack through the hardware, clear it, and write the packed form back. */
+	regs.scdivr = host_cpm.SCDIVR;
+	regs.pcdivr1 = host_cpm.PCDIVR1;
+	regs.pcdivr2 = host_cpm.PCDIVR2;
+	regs.pcdivr4 = host_cpm.PCDIVR4;
+	cpm_reset(CPM_CSWCFGR_SYS_SEL_OSC400M);
+
+	CHECK_EQ(ft9001_cpm_clk_regs_write(&regs), 0);
+	ft9001_cpm_clk_plan_get(&back);
+	plan_equal(&back, &s_plan);
+}
+
+static void test_disabled_divider_reads_zero(void)
+{
+	struct ft9001_cpm_clk_plan back;
+
+	cpm_reset(CPM_CSWCFGR_SYS_SEL_OSC400M);
+	CHECK_EQ(ft9001_cpm_clk_plan_apply(&s_plan), 0);
+
+	host_cpm.CDIVENR &= ~(CPM_CDIVENR_TC_DIVEN | CPM_CDIVENR_I2S_S_DIVEN);
+	ft9001_cpm_clk_plan_get(&back);
+	CHECK_EQ(back.tc_div, 0U);
+	CHECK_EQ(back.i2s_s_div, 0U);
+	CHECK_EQ(back.adc_div, s_plan.adc_div);
+}
+
+static void test_predict(void)
+{
+	uint32_t hz[FT9001_CPM_CLK_COUNT];
+
+	cpm_reset(CPM_CSWCFGR_SYS_SEL_OSC400M);
+
+	/* On a source given explicitly. */
+	CHECK_EQ(ft9001_cpm_clk_plan_check(&s_plan, 400000000UL, hz), 0);
+	CHECK_EQ(hz[FT9001_CPM_CLK_SYS], 200000000UL);
+	CHECK_EQ(hz[FT9001_CPM_CLK_AHB3], 100000000UL);
+	CHECK_EQ(hz[FT9001_CPM_CLK_ARITH], 66666666UL);
+	CHECK_EQ(hz[FT9001_CPM_CLK_IPS], 50000000UL);
+	CHECK_EQ(hz[FT9001_CPM_CLK_TC], 10000000UL);
+	CHECK_EQ(hz[FT9001_CPM_CLK_ADC], 8333333UL);
+	CHECK_EQ(hz[FT9001_CPM_CLK_MCC], 7142857UL);
+	CHECK_EQ(hz[FT9001_CPM_CLK_MESH], 6250000UL);
+	CHECK_EQ(hz[FT9001_CPM_CLK_TRACE], 200000000UL / 0xA6U);
+	CHECK_EQ(hz[FT9001_CPM_CLK_I2S_M], 200000000UL / 0x82U);
+	CHECK_EQ(hz[FT9001_CPM_CLK_I2S_S], 200000000UL / 0x100U);
+
+	/* On the current source, as the model sees it. */
+	CHECK_EQ(ft9001_cpm_clk_plan_check(&s_plan, 0U, hz), 0);
+	CHECK_EQ(hz[FT9001_CPM_CLK_SYS], ft9001_cpm_hsosc_freq_hz_get() / 2U);
+
+	cpm_reset(CPM_CSWCFGR_SYS_SEL_OSC8M);
+	CHECK_EQ(ft9001_cpm_clk_plan_check(&s_plan, 0U, hz), 0);
+	CHECK_EQ(hz[FT9001_CPM_CLK_SYS], 4000000UL);
+	CHECK_EQ(hz[FT9001_CPM_CLK_IPS], 1000000UL);
+
+	/* The model follows a committed plan. */
+	CHECK_EQ(ft9001_cpm_clk_plan_apply(&s_plan), 0);
+	CHECK_EQ(ft9001_cpm_clk_freq_hz_get(FT9001_CPM_CLK_IPS), 1000000UL);
+	CHECK_EQ(ft9001_cpm_sysclk_freq_hz_get(), 4000000UL);
+}
+
+static void test_check_refuses(void)
+{
+	struct ft9001_cpm_clk_plan plan = s_plan;
+	uint32_t hz[FT9001_CPM_CLK_COUNT];
+
+	cpm_reset(CPM_CSWCFGR_SYS_SEL_OSC400M);
+
+	plan.ips_div = 0x10U;
+	CHECK_EQ(ft9001_cpm_clk_plan_check(&plan, 0U, NULL), -EINVAL);
+	plan = s_plan;
+	plan.i2s_m_div = 0x100U;
+	CHECK_EQ(ft9001_cpm_clk_plan_check(&plan, 0U, NULL), -EINVAL);
+
+	/* 400 MHz undivided is over the SYS maximum; the rates still come back. */
+	plan = s_plan;
+	plan.sys_div = 0U;
+	CHECK_EQ(ft9001_cpm_clk_plan_check(&plan, 400000000UL, hz), -ERANGE);
+	CHECK_EQ(hz[FT9001_CPM_CLK_SYS], 400000000UL);
+
+	/* The SYS clock at its maximum, the IPS clock over its own. */
+	plan.sys_div = 1U;
+	plan.ips_div = 0U;
+	CHECK_EQ(ft9001_cpm_clk_plan_check(&plan, 2U * FT9001_CPM_SYS_MAX_HZ, NULL), -ERANGE);
+	plan.ips_div = 1U;
+	CHECK_EQ(ft9001_cpm_clk_plan_check(&plan, 2U * FT9001_CPM_SYS_MAX_HZ, NULL), 0);
+
+	/* Nothing is written for a refused plan. */
+	plan.sys_div = 0U;
+	CHECK_EQ(ft9001_cpm_clk_plan_apply(&plan), -ERANGE);
+	CHECK_EQ(host_cpm.CDIVENR, 0U);
+	CHECK_EQ(host_cpm.CDIVUPDR, 0U);
+	CHECK_EQ(host_cpm.SCDIVR, 0U);
+}
+
+static void test_div_setters(void)
+{
+	struct ft9001_cpm_clk_plan back;
+
+	cpm_reset(CPM_CSWCFGR_SYS_SEL_OSC400M);
+	CHECK_EQ(ft9001_cpm_clk_plan_apply(&s_plan), 0);
+
+	host_cpm.CDIVUPDR = 0U;
+	CHECK_EQ(ft9001_cpm_ips_div_set(9U), 0);
+	CHECK_EQ(host_cpm.CDIVUPDR, CPM_CDIVUPDR_SYSDIV_UPD | CPM_CDIVUPDR_PERDIV_UPD);
+	ft9001_cpm_clk_plan_get(&back);
+	CHECK_EQ(back.ips_div, 9U);
+	CHECK_EQ(back.sys_div, s_plan.sys_div);
+	CHECK_EQ(back.mesh_div, s_plan.mesh_div);
+
+	CHECK_EQ(ft9001_cpm_sys_ips_div_set(3U, 0U), 0);
+	CHECK_EQ(ft9001_cpm_sys_div_get(), 3U);
+	CHECK_EQ(ft9001_cpm_ips_div_get(), 0U);
+
+	CHECK_EQ(ft9001_cpm_ips_div_set(0x10U), -EINVAL);
+	CHECK_EQ(ft9001_cpm_sys_ips_div_set(0U, 0U), -ERANGE);
+	CHECK_EQ(ft9001_cpm_sys_div_get(), 3U);
+}
+
+static void test_listeners(void)
+{
+	struct notify_log log = {0};
+	struct ft9001_cpm_clk_listener l = {
+		.cb = log_post,
+		.pre_cb = log_pre,
+		.user_data = &log,
+		.mask = FT9001_CPM_CLK_BIT(FT9001_CPM_CLK_IPS),
+	};
+	struct ft9001_cpm_clk_plan plan = s_plan;
+
+	cpm_reset(CPM_CSWCFGR_SYS_SEL_OSC400M);
+	CHECK_EQ(ft9001_cpm_clk_plan_apply(&plan), 0);
+	CHECK_EQ(ft9001_cpm_clk_listener_register(&l), 0);
+	CHECK_EQ(ft9001_cpm_clk_listener_register(&l), -EALREADY);
+
+	/* Only the TC domain moves: not of interest. */
+	plan.tc_div = 0U;
+	CHECK_EQ(ft9001_cpm_clk_plan_apply(&plan), 0);
+	CHECK_EQ(log.pre_calls, 0U);
+	CHECK_EQ(log.calls, 0U);
+
+	/* IPS moves: told before with the next rate, after with the mask. */
+	plan.ips_div = 1U;
+	CHECK_EQ(ft9001_cpm_clk_plan_apply(&plan), 0);
+	CHECK_EQ(log.pre_calls, 1U);
+	CHECK_EQ(log.changing, FT9001_CPM_CLK_BIT(FT9001_CPM_CLK_IPS));
+	CHECK_EQ(log.next_ips_hz, ft9001_cpm_hsosc_freq_hz_get() / 4U);
+	CHECK_EQ(log.model_ips_hz_at_pre, ft9001_cpm_hsosc_freq_hz_get() / 8U);
+	CHECK_EQ(log.calls, 1U);
+	CHECK_EQ(log.changed, FT9001_CPM_CLK_BIT(FT9001_CPM_CLK_IPS));
+	CHECK_EQ(ft9001_cpm_ips_freq_hz_get(), log.next_ips_hz);
+
+	CHECK_EQ(ft9001_cpm_clk_listener_unregister(&l), 0);
+	CHECK_EQ(ft9001_cpm_clk_listener_unregister(&l), -ENOENT);
+}
+
+int main(void)
+{
+	test_apply_round_trip();
+	test_regs_round_trip();
+	test_disabled_divider_reads_zero();
+	test_predict();
+	test_check_refuses();
+	test_div_setters();
+	test_listeners();
+
+	return HOST_TEST_RESULT();
+}
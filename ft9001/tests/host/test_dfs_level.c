@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2026, FocalTech Systems CO.,Ltd
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Level read-back, step selection and the up-front plan check of
+ * ft9001_dfs.c. Built with SYS and IPS maxima of 100 MHz, which the idle
+ * level meets and the nominal and boost levels do not.
+ */
+
+#include <string.h>
+
+#include "host_test.h"
+
+#include "ft9001_cpm.c"
+#include "ft9001_cpm_stime.c"
+#include "ft9001_uart.c"
+#include "ft9001_dfs.c"
+
+/* OTP as parsed: a 320 MHz trim and no 400 MHz one. */
+static void otp_fake(void)
+{
+	s_otp.parsed = true;
+	s_otp.sel = 0U;
+	s_otp.part[0].valid = true;
+	s_otp.part[0].has_320 = true;
+	s_otp.has_400 = false;
+}
+
+/* What ft9001_cpm_hsosc_trim_get() reports. */
+struct trim_state {
+	bool loaded;
+	enum ft9001_cpm_osc_freq freq;
+};
+
+static const struct trim_state s_no_trim = {false, FT9001_CPM_OSC_FREQ_320MHZ};
+static const struct trim_state s_trim_320 = {true, FT9001_CPM_OSC_FREQ_320MHZ};
+static const struct trim_state s_trim_400 = {true, FT9001_CPM_OSC_FREQ_400MHZ};
+
+/* Hardware at an operating point, with the trim the HAL would have loaded. */
+static void hw_at(enum ft9001_cpm_sysclk_source src, const struct trim_state *trim,
+		  uint32_t sys_div, uint32_t ips_div, bool hsosc_on)
+{
+	host_cpm = (CPM_TypeDef){0};
+	host_cpm.CSWCFGR = (src == FT9001_CPM_SYSCLK_OSC400M) ? CPM_CSWCFGR_SYS_SEL_OSC400M
+							       : CPM_CSWCFGR_SYS_SEL_OSC8M;
+	host_cpm.SCDIVR = CPM_SCDIVR_SYS_DIV_VAL(sys_div);
+	host_cpm.PCDIVR1 = ips_div << CPM_PCDIVR1_IPS_DIV_Pos;
+	host_cpm.CDIVENR = CPM_PLAN_DIVEN;
+	host_cpm.OCSR = CPM_OCSR_OSC8M_EN | CPM_OCSR_OSC8M_STABLE;
+	if (hsosc_on) {
+		host_cpm.OCSR |= CPM_OCSR_OSC400M_EN | CPM_OCSR_OSC400M_STABLE;
+	}
+	s_hsosc_trim_loaded = trim->loaded;
+	s_hsosc_trim = trim->freq;
+	s_clk_tree_valid = false;
+}
+
+static void test_level_get(void)
+{
+	hw_at(FT9001_CPM_SYSCLK_OSC8M, &s_no_trim, 0U, 0U, false);
+	CHECK_EQ(ft9001_dfs_level_get(), FT9001_DFS_LEVEL_IDLE);
+
+	/* The IPS divider disabled reads as 0, which is what idle asks for. */
+	host_cpm.CDIVENR = 0U;
+	host_cpm.PCDIVR1 = 5U << CPM_PCDIVR1_IPS_DIV_Pos;
+	CHECK_EQ(ft9001_dfs_level_get(), FT9001_DFS_LEVEL_IDLE);
+
+	hw_at(FT9001_CPM_SYSCLK_OSC400M, &s_trim_320, 1U, 1U, true);
+	CHECK_EQ(ft9001_dfs_level_get(), FT9001_DFS_LEVEL_NOMINAL);
+
+	hw_at(FT9001_CPM_SYSCLK_OSC400M, &s_trim_400, 1U, 1U, true);
+	CHECK_EQ(ft9001_dfs_level_get(), FT9001_DFS_LEVEL_BOOST);
+
+	/* A trim the HAL did not load matches no high-speed level. */
+	hw_at(FT9001_CPM_SYSCLK_OSC400M, &s_no_trim, 1U, 1U, true);
+	CHECK_EQ(ft9001_dfs_level_get(), FT9001_DFS_LEVEL_COUNT);
+
+	/* Nor do dividers of no level. */
+	hw_at(FT9001_CPM_SYSCLK_OSC400M, &s_trim_320, 1U, 2U, true);
+	CHECK_EQ(ft9001_dfs_level_get(), FT9001_DFS_LEVEL_COUNT);
+	hw_at(FT9001_CPM_SYSCLK_OSC8M, &s_no_trim, 1U, 1U, false);
+	CHECK_EQ(ft9001_dfs_level_get(), FT9001_DFS_LEVEL_COUNT);
+}
+
+static void test_level_available(void)
+{
+	otp_fake();
+
+	CHECK(ft9001_dfs_level_available(FT9001_DFS_LEVEL_IDLE));
+	CHECK(ft9001_dfs_level_available(FT9001_DFS_LEVEL_NOMINAL));
+	CHECK(!ft9001_dfs_level_available(FT9001_DFS_LEVEL_BOOST));
+	CHECK(!ft9001_dfs_level_available(FT9001_DFS_LEVEL_COUNT));
+}
+
+static void test_step_selection(void)
+{
+	const uint32_t stime_us = 100U;
+	uint32_t stime_cycles = stime_us * STIME_CLK_MHZ;
+
+	/* Idle to nominal: trim, dividers, start the oscillator and switch. */
+	hw_at(FT9001_CPM_SYSCLK_OSC8M, &s_no_trim, 0U, 0U, false);
+	host_cpm.OSCHSTIMER = stime_cycles << CPM_STIMER_STIME_Pos;
+	CHECK_EQ(ft9001_dfs_latency_us_estimate(FT9001_DFS_LEVEL_NOMINAL),
+		 DFS_COST_SWITCH_US + DFS_COST_TRIM_US + DFS_COST_DIV_US + stime_us +
+			 DFS_COST_SWITCH_US);
+
+	/* Already there: nothing to do. */
+	hw_at(FT9001_CPM_SYSCLK_OSC400M, &s_trim_320, 1U, 1U, true);
+	CHECK_EQ(ft9001_dfs_latency_us_estimate(FT9001_DFS_LEVEL_NOMINAL), 0U);
+
+	/* Nominal to boost: only the trim changes, but loading it drops to
+	 * OSC8M, so the switch back is charged too. The oscillator stays on.
+	 */
+	CHECK_EQ(ft9001_dfs_latency_us_estimate(FT9001_DFS_LEVEL_BOOST),
+		 DFS_COST_SWITCH_US + DFS_COST_TRIM_US + DFS_COST_SWITCH_US);
+
+	/* Nominal to idle: switch down and dividers; stopping is free. */
+	CHECK_EQ(ft9001_dfs_latency_us_estimate(FT9001_DFS_LEVEL_IDLE),
+		 DFS_COST_SWITCH_US + DFS_COST_DIV_US);
+
+	CHECK_EQ(ft9001_dfs_latency_us_estimate(FT9001_DFS_LEVEL_COUNT), UINT32_MAX);
+}
+
+static void test_level_set_checks_first(void)
+{
+	CPM_TypeDef before;
+	uint32_t latency = 1234U;
+
+	otp_fake();
+
+	/* Nominal runs SYS at 160 MHz, over this build's 100 MHz maximum: refused
+	 * before any register is touched.
+	 */
+	hw_at(FT9001_CPM_SYSCLK_OSC8M, &s_no_trim, 0U, 0U, false);
+	before = host_cpm;
+	CHECK_EQ(ft9001_dfs_level_set(FT9001_DFS_LEVEL_NOMINAL, &latency), -ERANGE);
+	CHECK_EQ(memcmp(&before, &host_cpm, sizeof(before)), 0);
+	CHECK_EQ(latency, 1234U);
+
+	CHECK_EQ(ft9001_dfs_level_set(FT9001_DFS_LEVEL_COUNT, NULL), -EINVAL);
+
+	/* Idle from idle has no step to take. */
+	CHECK_EQ(ft9001_dfs_level_set(FT9001_DFS_LEVEL_IDLE, &latency), 0);
+	CHECK_EQ(memcmp(&before, &host_cpm, sizeof(before)), 0);
+	CHECK_EQ(latency, 0U);
+}
+
+int main(void)
+{
+	test_level_get();
+	test_level_available();
+	test_step_selection();
+	test_level_set_checks_first();
+
+	return HOST_TEST_RESULT();
+}
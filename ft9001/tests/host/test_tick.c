@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2026, FocalTech Systems CO.,Ltd
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Deadline arithmetic of ft9001_tick.h, with CTICKR set by hand. */
+
+#include "host_test.h"
+
+#include "ft9001_tick.h"
+
+static void tick_set(uint32_t ticks)
+{
+	host_cpm.CTICKR = ticks;
+}
+
+static void test_deadline_finite(void)
+{
+	struct ft9001_deadline dl;
+
+	tick_set(1000U);
+	ft9001_deadline_start(&dl, 100U);
+	CHECK_EQ(dl.ticks, 100U * FT9001_TICK_PER_US);
+	CHECK(!dl.forever);
+	CHECK(!ft9001_deadline_expired(&dl));
+	CHECK_EQ(ft9001_deadline_left_us(&dl), 100U);
+	CHECK_EQ(ft9001_deadline_elapsed_us(&dl), 0U);
+
+	tick_set(1000U + 40U * FT9001_TICK_PER_US + 3U);
+	CHECK(!ft9001_deadline_expired(&dl));
+	CHECK_EQ(ft9001_deadline_elapsed_us(&dl), 40U);
+	/* Partial microseconds are dropped. */
+	CHECK_EQ(ft9001_deadline_left_us(&dl), 59U);
+
+	tick_set(1000U + 100U * FT9001_TICK_PER_US - 1U);
+	CHECK(!ft9001_deadline_expired(&dl));
+	/* Never 0 while finite, so it is never taken for FOREVER. */
+	CHECK_EQ(ft9001_deadline_left_us(&dl), 1U);
+
+	tick_set(1000U + 100U * FT9001_TICK_PER_US);
+	CHECK(ft9001_deadline_expired(&dl));
+	CHECK_EQ(ft9001_deadline_left_us(&dl), 1U);
+
+	tick_set(1000U + 500U * FT9001_TICK_PER_US);
+	CHECK(ft9001_deadline_expired(&dl));
+	CHECK_EQ(ft9001_deadline_elapsed_us(&dl), 500U);
+	CHECK_EQ(ft9001_deadline_left_us(&dl), 1U);
+}
+
+static void test_deadline_wrap(void)
+{
+	struct ft9001_deadline dl;
+
+	/* Started just before the counter wraps. */
+	tick_set(UINT32_MAX - 15U);
+	ft9001_deadline_start(&dl, 10U);
+
+	tick_set(UINT32_MAX);
+	CHECK(!ft9001_deadline_expired(&dl));
+	CHECK_EQ(ft9001_deadline_elapsed_us(&dl), 1U);
+
+	tick_set(63U);
+	CHECK(!ft9001_deadline_expired(&dl));
+	CHECK_EQ(ft9001_deadline_elapsed_us(&dl), 9U);
+	CHECK_EQ(ft9001_deadline_left_us(&dl), 1U);
+
+	tick_set(64U);
+	CHECK(ft9001_deadline_expired(&dl));
+	CHECK_EQ(ft9001_deadline_elapsed_us(&dl), 10U);
+}
+
+static void test_deadline_forever(void)
+{
+	struct ft9001_deadline dl;
+
+	tick_set(5U);
+	ft9001_deadline_start(&dl, FT9001_TICK_FOREVER);
+	CHECK(dl.forever);
+
+	tick_set(4U);
+	CHECK(!ft9001_deadline_expired(&dl));
+	CHECK_EQ(ft9001_deadline_left_us(&dl), FT9001_TICK_FOREVER);
+}
+
+static void test_deadline_clamp(void)
+{
+	struct ft9001_deadline dl;
+
+	tick_set(0U);
+	ft9001_deadline_start(&dl, UINT32_MAX);
+	CHECK(!dl.forever);
+	CHECK_EQ(dl.ticks, FT9001_TICK_TIMEOUT_MAX_US * FT9001_TICK_PER_US);
+	CHECK_EQ(ft9001_deadline_left_us(&dl), FT9001_TICK_TIMEOUT_MAX_US);
+
+	tick_set(dl.ticks);
+	CHECK(ft9001_deadline_expired(&dl));
+}
+
+static void test_wait_bits(void)
+{
+	volatile uint32_t reg = 0x5U;
+	uint32_t waited = UINT32_MAX;
+
+	/* Already matching: no wait at all. */
+	tick_set(77U);
+	CHECK_EQ(ft9001_tick_wait_bits(&reg, 0x4U, 0x4U, 10U, &waited), 0);
+	CHECK_EQ(waited, 0U);
+
+	/* The value is compared under the mask, so cleared bits match too. */
+	CHECK_EQ(ft9001_tick_wait_bits(&reg, 0x2U, 0x0U, 10U, NULL), 0);
+}
+
+int main(void)
+{
+	test_deadline_finite();
+	test_deadline_wrap();
+	test_deadline_forever();
+	test_deadline_clamp();
+	test_wait_bits();
+
+	return HOST_TEST_RESULT();
+}